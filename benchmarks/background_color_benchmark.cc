@@ -0,0 +1,136 @@
+// Compares the Linux plugin's set_background_color with the version it
+// replaced, for the updates a background tint animation sends: one per
+// frame, and with a subtle tint many frames round to the color of the frame
+// before.
+//
+// The old version formatted the color with gdk_rgba_to_string and parsed
+// the CSS into the provider on every call. The new one skips colors it
+// already loaded and formats the CSS from the integer channels. Needs a
+// display for the style context; run it under Xvfb on a headless machine:
+//
+//   xvfb-run -a ./background_color_benchmark
+//
+// Without a display it exits with 77, which ctest reports as skipped.
+
+#include <gtk/gtk.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace {
+
+using window_manager_plus::benchmark::Measure;
+using window_manager_plus::benchmark::ParseIterations;
+
+struct Color {
+  gint64 red;
+  gint64 green;
+  gint64 blue;
+  gint64 alpha;
+};
+
+// A 300 ms tint from white to an off-white and back at 60 frames per
+// second, as an AnimationController driving setBackgroundColor sends it.
+// The update before the first is the last, both white.
+std::vector<Color> TintAnimation() {
+  const int kFrames = 18;
+  std::vector<Color> colors;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int frame = 0; frame <= kFrames; frame++) {
+      double t = static_cast<double>(frame) / kFrames;
+      if (pass == 1)
+        t = 1 - t;
+      auto lerp = [t](gint64 from, gint64 to) {
+        return static_cast<gint64>(std::round(from + (to - from) * t));
+      };
+      colors.push_back({lerp(255, 249), lerp(255, 250), lerp(255, 252), 255});
+    }
+  }
+  return colors;
+}
+
+// The set_background_color of the old plugin.
+void SetColorOld(GtkCssProvider* provider, const Color& color) {
+  GdkRGBA rgba;
+  rgba.red = color.red / 255.0;
+  rgba.green = color.green / 255.0;
+  rgba.blue = color.blue / 255.0;
+  rgba.alpha = color.alpha / 255.0;
+  g_autofree gchar* string = gdk_rgba_to_string(&rgba);
+  g_autofree gchar* css =
+      g_strdup_printf("window { background-color: %s; }", string);
+  gtk_css_provider_load_from_data(provider, css, -1, nullptr);
+}
+
+// The set_background_color of the plugin, with |loaded| standing in for
+// the plugin's background_color.
+void SetColorNew(GtkCssProvider* provider, const Color& color,
+                 gint64* loaded) {
+  gint64 key =
+      (color.red << 24) | (color.green << 16) | (color.blue << 8) | color.alpha;
+  if (key == *loaded)
+    return;
+
+  gchar alpha_string[G_ASCII_DTOSTR_BUF_SIZE];
+  g_ascii_dtostr(alpha_string, sizeof(alpha_string), color.alpha / 255.0);
+  g_autofree gchar* css = g_strdup_printf(
+      "window { background-color: rgba(%d, %d, %d, %s); }",
+      static_cast<int>(color.red), static_cast<int>(color.green),
+      static_cast<int>(color.blue), alpha_string);
+  gtk_css_provider_load_from_data(provider, css, -1, nullptr);
+  *loaded = key;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations = ParseIterations(argc, argv, 200);
+  if (!gtk_init_check(&argc, &argv)) {
+    printf("no display, skipped\n");
+    return 77;
+  }
+
+  // The provider is attached to a window like the plugin's, so every load
+  // invalidates a style context as it does there.
+  GtkWidget* window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  GtkCssProvider* provider = gtk_css_provider_new();
+  gtk_style_context_add_provider(gtk_widget_get_style_context(window),
+                                 GTK_STYLE_PROVIDER(provider),
+                                 GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+
+  std::vector<Color> colors = TintAnimation();
+  size_t changes = 0;
+  for (size_t i = 0; i < colors.size(); i++) {
+    const Color& a = colors[i];
+    const Color& b = colors[i == 0 ? colors.size() - 1 : i - 1];
+    if (a.red != b.red || a.green != b.green || a.blue != b.blue ||
+        a.alpha != b.alpha) {
+      changes++;
+    }
+  }
+  printf("tint animation: %zu updates, %zu color changes\n", colors.size(),
+         changes);
+
+  double old_ns =
+      Measure("CSS parsed on every update", iterations, colors.size(), [&] {
+        for (const Color& color : colors) {
+          SetColorOld(provider, color);
+        }
+      });
+  gint64 loaded = -1;
+  double new_ns =
+      Measure("unchanged colors skipped", iterations, colors.size(), [&] {
+        for (const Color& color : colors) {
+          SetColorNew(provider, color, &loaded);
+        }
+      });
+  printf("  %-40s %10.1fx\n", "speedup", old_ns / new_ns);
+
+  g_object_unref(provider);
+  gtk_widget_destroy(window);
+  return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef WINDOW_MANAGER_PLUS_BENCHMARKS_BENCHMARK_H_
+#define WINDOW_MANAGER_PLUS_BENCHMARKS_BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace window_manager_plus {
+namespace benchmark {
+
+// Returns the value of "--iterations N" on the command line, or |fallback|.
+// ctest passes a small count so the benchmarks double as smoke tests.
+inline int64_t ParseIterations(int argc, char** argv, int64_t fallback) {
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0) {
+      return std::max<int64_t>(1, strtoll(argv[i + 1], nullptr, 10));
+    }
+  }
+  return fallback;
+}
+
+// Reads a trace file with one entry per line, skipping blank lines and
+// lines starting with '#'. Exits if the file can't be read.
+inline std::vector<std::string> LoadTrace(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    fprintf(stderr, "can't read trace %s\n", path.c_str());
+    exit(1);
+  }
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// Keeps the optimizer from discarding a result the benchmark doesn't use.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+// Runs |round| once to warm up, then |iterations| more times, and prints the
+// mean time of one of the |ops_per_round| operations a round performs.
+// Returns that time in nanoseconds.
+template <typename Round>
+double Measure(const char* label,
+               int64_t iterations,
+               size_t ops_per_round,
+               Round round) {
+  round();
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < iterations; i++) {
+    round();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+              static_cast<double>(iterations) /
+              static_cast<double>(ops_per_round == 0 ? 1 : ops_per_round);
+  printf("  %-40s %10.1f ns/op\n", label, ns);
+  return ns;
+}
+
+}  // namespace benchmark
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_BENCHMARKS_BENCHMARK_H_
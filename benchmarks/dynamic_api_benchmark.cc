@@ -0,0 +1,73 @@
+// Compares DynamicApi with looking the entry points up on every call, the
+// way SetBackgroundColor did for SetWindowCompositionAttribute and
+// MonitorCache did for GetDpiForMonitor. Windows only.
+
+#include <windows.h>
+
+#include <cstdint>
+#include <cstdio>
+
+#include "benchmark.h"
+#include "dynamic_api.h"
+
+namespace {
+
+using window_manager_plus::DynamicApi;
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+using window_manager_plus::benchmark::ParseIterations;
+
+constexpr size_t kCallsPerRound = 256;
+
+// What SetBackgroundColor did before every call.
+FARPROC LookupSetWindowCompositionAttribute() {
+  HMODULE user32 = LoadLibrary(L"user32.dll");
+  FARPROC function = GetProcAddress(user32, "SetWindowCompositionAttribute");
+  FreeLibrary(user32);
+  return function;
+}
+
+// What MonitorCache did on every refresh.
+FARPROC LookupGetDpiForMonitor() {
+  HMODULE shcore = LoadLibrary(L"shcore.dll");
+  FARPROC function = GetProcAddress(shcore, "GetDpiForMonitor");
+  FreeLibrary(shcore);
+  return function;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations = ParseIterations(argc, argv, 1000);
+  // Keeps shcore.dll loaded the way DynamicApi does, so the per call lookup
+  // is not measured with the module being mapped and unmapped each time.
+  DynamicApi::Get();
+
+  printf("SetWindowCompositionAttribute\n");
+  double old_ns =
+      Measure("LoadLibrary per call", iterations, kCallsPerRound, [] {
+        for (size_t i = 0; i < kCallsPerRound; i++) {
+          DoNotOptimize(LookupSetWindowCompositionAttribute());
+        }
+      });
+  double new_ns = Measure("DynamicApi", iterations, kCallsPerRound, [] {
+    for (size_t i = 0; i < kCallsPerRound; i++) {
+      DoNotOptimize(DynamicApi::Get().set_window_composition_attribute);
+    }
+  });
+  printf("  %-40s %10.1fx\n", "speedup", old_ns / new_ns);
+
+  printf("GetDpiForMonitor\n");
+  old_ns = Measure("LoadLibrary per call", iterations, kCallsPerRound, [] {
+    for (size_t i = 0; i < kCallsPerRound; i++) {
+      DoNotOptimize(LookupGetDpiForMonitor());
+    }
+  });
+  new_ns = Measure("DynamicApi", iterations, kCallsPerRound, [] {
+    for (size_t i = 0; i < kCallsPerRound; i++) {
+      DoNotOptimize(DynamicApi::Get().get_dpi_for_monitor);
+    }
+  });
+  printf("  %-40s %10.1fx\n", "speedup", old_ns / new_ns);
+  return 0;
+}
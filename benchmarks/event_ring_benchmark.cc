@@ -0,0 +1,148 @@
+// Moves a burst of move/resize events from a producer thread to a consumer
+// thread, like the window proc and the UI thread do: once through the
+// EventRingBuffer of the event fast path, drained in batches, and once the
+// way the method channel path does it, building a map per event and handing
+// it over under a lock.
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "benchmark.h"
+#include "event_ring_buffer.h"
+
+namespace {
+
+using window_manager_plus::EventRingBuffer;
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+
+// The layout of WindowManagerPlusEvent in the plugin headers.
+struct Event {
+  int32_t event_id;
+  int32_t reserved;
+  int64_t window_id;
+  int64_t timestamp_us;
+  double x;
+  double y;
+  double width;
+  double height;
+};
+
+using Value = std::variant<int64_t, double, std::string>;
+using EventMap = std::map<std::string, Value>;
+
+constexpr size_t kEventsPerRound = 10000;
+constexpr size_t kDrainBatch = 256;
+
+Event MakeEvent(size_t i) {
+  Event event = {};
+  event.event_id = i % 2 == 0 ? 1 : 2;
+  event.window_id = 1;
+  event.timestamp_us = static_cast<int64_t>(i);
+  event.x = static_cast<double>(i);
+  event.y = 100;
+  event.width = 800;
+  event.height = 600;
+  return event;
+}
+
+// Returns the sum of the x of every event the consumer saw, so the checks
+// below can tell a lost or reordered event.
+double RingRound() {
+  EventRingBuffer<Event> ring;
+  double sum = 0;
+  std::thread consumer([&] {
+    Event batch[kDrainBatch];
+    size_t received = 0;
+    while (received < kEventsPerRound) {
+      size_t count = ring.Drain(batch, kDrainBatch);
+      for (size_t i = 0; i < count; i++) {
+        sum += batch[i].x;
+      }
+      received += count;
+      if (count == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  for (size_t i = 0; i < kEventsPerRound; i++) {
+    Event event = MakeEvent(i);
+    // The window proc falls back to the channel when the ring is full; here
+    // the producer waits instead so every event goes through the ring.
+    while (!ring.Push(event)) {
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+  return sum;
+}
+
+double ChannelRound() {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<EventMap>> queue;
+  double sum = 0;
+  std::thread consumer([&] {
+    std::vector<std::unique_ptr<EventMap>> batch;
+    size_t received = 0;
+    while (received < kEventsPerRound) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.swap(queue);
+      }
+      for (const auto& event : batch) {
+        sum += std::get<double>(event->at("x"));
+      }
+      received += batch.size();
+      if (batch.empty()) {
+        std::this_thread::yield();
+      }
+      batch.clear();
+    }
+  });
+  for (size_t i = 0; i < kEventsPerRound; i++) {
+    Event event = MakeEvent(i);
+    auto map = std::make_unique<EventMap>();
+    (*map)["eventName"] =
+        std::string(event.event_id == 1 ? "move" : "resize");
+    (*map)["windowId"] = event.window_id;
+    (*map)["x"] = event.x;
+    (*map)["y"] = event.y;
+    (*map)["width"] = event.width;
+    (*map)["height"] = event.height;
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(map));
+  }
+  consumer.join();
+  return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations =
+      window_manager_plus::benchmark::ParseIterations(argc, argv, 200);
+
+  double expected = 0;
+  for (size_t i = 0; i < kEventsPerRound; i++) {
+    expected += MakeEvent(i).x;
+  }
+  if (RingRound() != expected || ChannelRound() != expected) {
+    fprintf(stderr, "events were lost\n");
+    return 1;
+  }
+
+  printf("event ring: %zu events per round, %lld rounds\n", kEventsPerRound,
+         static_cast<long long>(iterations));
+  Measure("map per event under a lock", iterations, kEventsPerRound,
+          [] { DoNotOptimize(ChannelRound()); });
+  Measure("EventRingBuffer", iterations, kEventsPerRound,
+          [] { DoNotOptimize(RingRound()); });
+  return 0;
+}
@@ -0,0 +1,137 @@
+// Replays the non-client messages of a window session through the frame
+// decisions HandleWindowProc makes for WM_NCCALCSIZE and WM_NCACTIVATE: a
+// model of the original ones comparing title_bar_style_ as a std::string,
+// and NcCalcSizeAction and NcActivateAction of window_proc_core.h testing
+// the precomputed frame_mode_ bits. Both have to take the same decision for
+// every message and every title bar style.
+//
+// The per-message GetVersion call the original code made can't be run off
+// Windows, so it is left out; the comparison only covers the style checks.
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "window_proc_core.h"
+
+namespace {
+
+using window_manager_plus::FrameAction;
+using window_manager_plus::kFrameModeFrameless;
+using window_manager_plus::kFrameModeHiddenTitleBar;
+using window_manager_plus::NcActivateAction;
+using window_manager_plus::NcCalcSizeAction;
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+
+enum Message : uint8_t { kNcCalcSize, kNcActivate };
+
+enum WindowState : uint8_t { kNormal, kMaximized, kFullScreen };
+
+struct TraceMessage {
+  Message message;
+  bool wparam;
+  WindowState state;
+};
+
+// The frame decisions HandleWindowProc made before frame_mode_, testing
+// is_frameless_ and comparing title_bar_style_ as a std::string per message.
+struct LegacyWindow {
+  std::string title_bar_style_;
+  bool is_frameless_;
+};
+
+FrameAction LegacyDecision(const LegacyWindow& window, const TraceMessage& m) {
+  bool is_full_screen = m.state == kFullScreen;
+  bool is_maximized = m.state == kMaximized;
+  if (m.wparam && m.message == kNcCalcSize) {
+    if (is_full_screen && window.title_bar_style_ != "normal") {
+      return window.is_frameless_ ? FrameAction::kInsetToWorkArea
+                                  : FrameAction::kReturnZero;
+    }
+    if (window.is_frameless_) {
+      return is_maximized ? FrameAction::kInsetToWorkArea
+                          : FrameAction::kReturnZero;
+    }
+    if (window.title_bar_style_ == "hidden") {
+      return is_maximized ? FrameAction::kInsetToWorkArea
+                          : FrameAction::kHideTitleBar;
+    }
+  } else if (m.message == kNcActivate) {
+    if (window.title_bar_style_ == "hidden" || window.is_frameless_)
+      return FrameAction::kReturnOne;
+  }
+  return FrameAction::kDefault;
+}
+
+// The decision of HandleWindowProc, through window_proc_core.h.
+FrameAction FrameModeDecision(uint8_t frame_mode, const TraceMessage& m) {
+  if (m.wparam && m.message == kNcCalcSize) {
+    return NcCalcSizeAction(frame_mode, m.state == kFullScreen,
+                            m.state == kMaximized);
+  } else if (m.message == kNcActivate) {
+    return NcActivateAction(frame_mode);
+  }
+  return FrameAction::kDefault;
+}
+
+std::vector<TraceMessage> ParseTrace(const std::vector<std::string>& lines) {
+  std::vector<TraceMessage> trace;
+  for (const std::string& line : lines) {
+    std::istringstream fields(line);
+    std::string message, state;
+    int wparam = 0;
+    fields >> message >> wparam >> state;
+    trace.push_back(
+        {message == "WM_NCACTIVATE" ? kNcActivate : kNcCalcSize, wparam != 0,
+         state == "fullscreen"  ? kFullScreen
+         : state == "maximized" ? kMaximized
+                                : kNormal});
+  }
+  return trace;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations =
+      window_manager_plus::benchmark::ParseIterations(argc, argv, 20000);
+  std::vector<TraceMessage> trace =
+      ParseTrace(window_manager_plus::benchmark::LoadTrace(
+          std::string(TRACE_DIR) + "/frame_messages.txt"));
+
+  for (const char* style : {"normal", "hidden"}) {
+    for (bool frameless : {false, true}) {
+      LegacyWindow legacy = {style, frameless};
+      uint8_t frame_mode = (frameless ? kFrameModeFrameless : 0) |
+                           (legacy.title_bar_style_ == "hidden"
+                                ? kFrameModeHiddenTitleBar
+                                : 0);
+      for (const TraceMessage& m : trace) {
+        if (LegacyDecision(legacy, m) != FrameModeDecision(frame_mode, m)) {
+          fprintf(stderr, "decisions differ for %s%s\n", style,
+                  frameless ? ", frameless" : "");
+          return 1;
+        }
+      }
+
+      printf("frame mode: %s title bar%s, %zu messages, %lld rounds\n", style,
+             frameless ? ", frameless" : "", trace.size(),
+             static_cast<long long>(iterations));
+      Measure("std::string title_bar_style_", iterations, trace.size(), [&] {
+        for (const TraceMessage& m : trace) {
+          DoNotOptimize(LegacyDecision(legacy, m));
+        }
+      });
+      Measure("frame_mode_ bits", iterations, trace.size(), [&] {
+        for (const TraceMessage& m : trace) {
+          DoNotOptimize(FrameModeDecision(frame_mode, m));
+        }
+      });
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+// Compares the Linux plugin's cached toplevel GtkWindow and GdkWindow with
+// resolving them on every call, the way get_window() and get_gdk_window()
+// used to, for the getters every window polls and for hide(), which looked
+// the window up five times.
+//
+// The view is a GtkDrawingArea in a GtkEventBox in a realized GtkWindow,
+// nested like the FlView the plugin controls. Reading the view back from the
+// registrar is a field access and is modelled as one. Needs a display; run
+// it under Xvfb on a headless machine:
+//
+//   xvfb-run -a ./gtk_window_lookup_benchmark
+//
+// Without a display it exits with 77, which ctest reports as skipped.
+
+#include <gtk/gtk.h>
+
+#include <cstdint>
+#include <cstdio>
+
+#include "benchmark.h"
+
+namespace {
+
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+using window_manager_plus::benchmark::ParseIterations;
+
+constexpr size_t kCallsPerRound = 1024;
+
+// What the plugin keeps for its window before and after the caching.
+struct Plugin {
+  GtkWidget* view;
+  GtkWindow* window;
+  GdkWindow* gdk_window;
+};
+
+// The get_window() of the old plugin.
+GtkWindow* LookupWindow(const Plugin& plugin) {
+  return GTK_WINDOW(gtk_widget_get_toplevel(plugin.view));
+}
+
+// The get_gdk_window() of the old plugin.
+GdkWindow* LookupGdkWindow(const Plugin& plugin) {
+  return gtk_widget_get_window(GTK_WIDGET(LookupWindow(plugin)));
+}
+
+// Measures |call| with the window looked up on every use against the cached
+// pointers and prints how much of a call the lookups were.
+template <typename Call>
+void Compare(const char* name, int64_t iterations, const Plugin& plugin,
+             Call call) {
+  printf("%s\n", name);
+  double uncached =
+      Measure("looked up per use", iterations, kCallsPerRound, [&] {
+        for (size_t i = 0; i < kCallsPerRound; i++) {
+          call(plugin, true);
+        }
+      });
+  double cached = Measure("cached", iterations, kCallsPerRound, [&] {
+    for (size_t i = 0; i < kCallsPerRound; i++) {
+      call(plugin, false);
+    }
+  });
+  printf("  %-40s %10.1f ns/op\n", "saved per call", uncached - cached);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations = ParseIterations(argc, argv, 2000);
+  if (!gtk_init_check(&argc, &argv)) {
+    printf("no display, skipped\n");
+    return 77;
+  }
+
+  GtkWidget* toplevel = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+  GtkWidget* event_box = gtk_event_box_new();
+  GtkWidget* view = gtk_drawing_area_new();
+  gtk_container_add(GTK_CONTAINER(event_box), view);
+  gtk_container_add(GTK_CONTAINER(toplevel), event_box);
+  gtk_window_set_default_size(GTK_WINDOW(toplevel), 1280, 720);
+  gtk_widget_realize(toplevel);
+
+  Plugin plugin = {view, GTK_WINDOW(toplevel),
+                   gtk_widget_get_window(toplevel)};
+
+  Compare("isVisible", iterations, plugin,
+          [](const Plugin& p, bool lookup) {
+            GtkWindow* window = lookup ? LookupWindow(p) : p.window;
+            DoNotOptimize(gtk_widget_is_visible(GTK_WIDGET(window)));
+          });
+  Compare("isMaximized", iterations, plugin,
+          [](const Plugin& p, bool lookup) {
+            GtkWindow* window = lookup ? LookupWindow(p) : p.window;
+            DoNotOptimize(gtk_window_is_maximized(window));
+          });
+  Compare("isMinimized", iterations, plugin,
+          [](const Plugin& p, bool lookup) {
+            GdkWindow* window = lookup ? LookupGdkWindow(p) : p.gdk_window;
+            DoNotOptimize(gdk_window_get_state(window));
+          });
+  Compare("getBounds", iterations, plugin, [](const Plugin& p, bool lookup) {
+    gint x, y, width, height;
+    gtk_window_get_position(lookup ? LookupWindow(p) : p.window, &x, &y);
+    gtk_window_get_size(lookup ? LookupWindow(p) : p.window, &width, &height);
+    DoNotOptimize(x + y + width + height);
+  });
+  // hide() itself unmaps the window; only its five lookups are measured.
+  Compare("hide (window lookups only)", iterations, plugin,
+          [](const Plugin& p, bool lookup) {
+            if (lookup) {
+              for (int i = 0; i < 5; i++) {
+                DoNotOptimize(LookupWindow(p));
+              }
+            } else {
+              DoNotOptimize(p.window);
+            }
+          });
+
+  gtk_widget_destroy(toplevel);
+  return 0;
+}
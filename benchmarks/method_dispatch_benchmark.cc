@@ -0,0 +1,148 @@
+// Replays a method channel trace through the ways the plugins have looked up
+// method handlers: the Linux plugin's original chain of g_strcmp0 calls, the
+// GHashTable it uses now, and the sorted MethodDispatchTable of the Windows
+// plugin. Every lookup has to resolve to the same handler in each of them.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef HAVE_GLIB
+#include <glib.h>
+#endif
+
+#include "benchmark.h"
+#include "method_dispatch.h"
+
+namespace {
+
+using window_manager_plus::MethodDispatchEntry;
+using window_manager_plus::MethodDispatchTable;
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+
+// The methods in the order the original g_strcmp0 chain tested them.
+constexpr const char* kChainMethods[] = {
+    "ensureInitialized", "waitUntilReadyToShow", "setAsFrameless", "destroy",
+    "close", "setPreventClose", "isPreventClose", "focus", "blur", "isFocused",
+    "show", "hide", "isVisible", "isMaximized", "maximize", "unmaximize",
+    "isMinimized", "minimize", "restore", "isDockable", "isDocked", "dock",
+    "undock", "isFullScreen", "setFullScreen", "setAspectRatio",
+    "setBackgroundColor", "getBounds", "setBounds", "setMinimumSize",
+    "setMaximumSize", "isResizable", "setResizable", "isMinimizable",
+    "setMinimizable", "isMaximizable", "setMaximizable", "isClosable",
+    "setClosable", "isAlwaysOnTop", "setAlwaysOnTop", "isAlwaysOnBottom",
+    "setAlwaysOnBottom", "getTitle", "setTitle", "setTitleBarStyle",
+    "getTitleBarHeight", "isSkipTaskbar", "setSkipTaskbar", "setIcon",
+    "getOpacity", "setOpacity", "popUpWindowMenu", "startDragging",
+    "startResizing", "grabKeyboard", "ungrabKeyboard", "setBrightness",
+};
+
+constexpr size_t kMethodCount = sizeof(kChainMethods) / sizeof(*kChainMethods);
+
+// The handler a lookup resolves to is the method's entry in kChainMethods.
+using Handler = const char* const*;
+
+Handler ChainLookup(const char* method) {
+  for (size_t i = 0; i < kMethodCount; i++) {
+    if (strcmp(method, kChainMethods[i]) == 0) {
+      return &kChainMethods[i];
+    }
+  }
+  return nullptr;
+}
+
+// g_str_hash, so the hash map behaves like a GHashTable built with
+// g_str_hash and g_str_equal where glib isn't available.
+struct StrHash {
+  size_t operator()(std::string_view value) const {
+    uint32_t hash = 5381;
+    for (char c : value) {
+      hash = (hash << 5) + hash + static_cast<signed char>(c);
+    }
+    return hash;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations =
+      window_manager_plus::benchmark::ParseIterations(argc, argv, 20000);
+  std::vector<std::string> trace = window_manager_plus::benchmark::LoadTrace(
+      std::string(TRACE_DIR) + "/method_calls.txt");
+
+  MethodDispatchEntry<Handler> entries[kMethodCount];
+  for (size_t i = 0; i < kMethodCount; i++) {
+    entries[i] = {kChainMethods[i], &kChainMethods[i]};
+  }
+  std::sort(std::begin(entries), std::end(entries),
+            [](const MethodDispatchEntry<Handler>& a,
+               const MethodDispatchEntry<Handler>& b) {
+              return a.name < b.name;
+            });
+  MethodDispatchTable<Handler, kMethodCount> table(entries);
+
+  std::unordered_map<std::string_view, Handler, StrHash> hash_map;
+  for (size_t i = 0; i < kMethodCount; i++) {
+    hash_map.emplace(kChainMethods[i], &kChainMethods[i]);
+  }
+
+#ifdef HAVE_GLIB
+  GHashTable* hash_table = g_hash_table_new(g_str_hash, g_str_equal);
+  for (size_t i = 0; i < kMethodCount; i++) {
+    g_hash_table_insert(hash_table, const_cast<char*>(kChainMethods[i]),
+                        const_cast<char**>(&kChainMethods[i]));
+  }
+#endif
+
+  // Check every dispatcher agrees before timing any of them.
+  for (const std::string& method : trace) {
+    Handler expected = ChainLookup(method.c_str());
+    if (expected == nullptr) {
+      fprintf(stderr, "trace method %s is not dispatched\n", method.c_str());
+      return 1;
+    }
+    auto it = hash_map.find(method);
+    bool same = table.Find(method) == expected && it != hash_map.end() &&
+                it->second == expected;
+#ifdef HAVE_GLIB
+    same = same && g_hash_table_lookup(hash_table, method.c_str()) == expected;
+#endif
+    if (!same) {
+      fprintf(stderr, "dispatchers disagree on %s\n", method.c_str());
+      return 1;
+    }
+  }
+
+  printf("method dispatch: %zu calls, %zu methods, %lld rounds\n",
+         trace.size(), kMethodCount, static_cast<long long>(iterations));
+  double chain = Measure("strcmp chain", iterations, trace.size(), [&] {
+    for (const std::string& method : trace) {
+      DoNotOptimize(ChainLookup(method.c_str()));
+    }
+  });
+  Measure("hash map (g_str_hash)", iterations, trace.size(), [&] {
+    for (const std::string& method : trace) {
+      DoNotOptimize(hash_map.find(method)->second);
+    }
+  });
+#ifdef HAVE_GLIB
+  Measure("GHashTable", iterations, trace.size(), [&] {
+    for (const std::string& method : trace) {
+      DoNotOptimize(g_hash_table_lookup(hash_table, method.c_str()));
+    }
+  });
+  g_hash_table_unref(hash_table);
+#endif
+  double sorted = Measure("MethodDispatchTable", iterations, trace.size(), [&] {
+    for (const std::string& method : trace) {
+      DoNotOptimize(table.Find(method));
+    }
+  });
+  printf("  sorted table vs chain: %.1fx\n", chain / sorted);
+  return 0;
+}
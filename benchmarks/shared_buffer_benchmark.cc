@@ -0,0 +1,113 @@
+// Sends payloads of 1 KB to 64 MB from one window to another: the way
+// invokeMethodToWindow passes a Uint8List over the method channels, and as a
+// SharedWindowBuffer of the SharedBufferArena, where only the buffer id
+// travels. Filling the payload on the sending side is the same for both and
+// not measured.
+//
+// The channel path copies the payload four times: the plugin decodes the
+// sender's message, copies the arguments into a new EncodableValue, encodes
+// it on the target window's channel, and the target engine decodes it. The
+// codec here only frames a byte list the way the standard codec does.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "shared_buffer_arena.h"
+
+namespace {
+
+using window_manager_plus::SharedBufferArena;
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+
+constexpr uint8_t kUint8ListType = 8;
+
+std::vector<uint8_t> Encode(const std::vector<uint8_t>& bytes) {
+  std::vector<uint8_t> message(1 + sizeof(uint64_t) + bytes.size());
+  uint64_t size = bytes.size();
+  message[0] = kUint8ListType;
+  memcpy(&message[1], &size, sizeof(size));
+  memcpy(&message[1 + sizeof(size)], bytes.data(), bytes.size());
+  return message;
+}
+
+std::vector<uint8_t> Decode(const std::vector<uint8_t>& message) {
+  uint64_t size = 0;
+  memcpy(&size, &message[1], sizeof(size));
+  const uint8_t* data = &message[1 + sizeof(size)];
+  return std::vector<uint8_t>(data, data + size);
+}
+
+// Returns the last byte the target window sees.
+uint8_t SendOverChannels(const std::vector<uint8_t>& sender_message) {
+  std::vector<uint8_t> args = Decode(sender_message);
+  std::vector<uint8_t> target_args = args;
+  args = {};
+  std::vector<uint8_t> target_message = Encode(target_args);
+  target_args = {};
+  std::vector<uint8_t> received = Decode(target_message);
+  return received.empty() ? 0 : received.back();
+}
+
+uint8_t SendThroughArena(int64_t size) {
+  SharedBufferArena& arena = SharedBufferArena::GetInstance();
+  int64_t id = arena.Allocate(size);
+  uint8_t* data = arena.GetData(id);
+  data[size - 1] = 1;
+  // retainSharedWindowBuffer before the id is sent, then the target adopts
+  // the buffer and maps it.
+  arena.Retain(id);
+  uint8_t* received = arena.GetData(id);
+  uint8_t last = received[arena.GetSize(id) - 1];
+  arena.Release(id);
+  arena.Release(id);
+  return last;
+}
+
+std::string SizeLabel(int64_t size) {
+  return size >= (1 << 20) ? std::to_string(size >> 20) + " MB"
+                           : std::to_string(size >> 10) + " KB";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Rounds for the smallest payload, fewer for larger ones so every size
+  // moves about the same number of bytes.
+  int64_t iterations =
+      window_manager_plus::benchmark::ParseIterations(argc, argv, 20000);
+
+  for (int64_t size : {int64_t{1} << 10, int64_t{64} << 10, int64_t{1} << 20,
+                       int64_t{16} << 20, int64_t{64} << 20}) {
+    int64_t rounds = std::max<int64_t>(1, iterations * 1024 / size);
+    std::vector<uint8_t> payload(static_cast<size_t>(size), 0);
+    payload.back() = 1;
+    std::vector<uint8_t> sender_message = Encode(payload);
+    payload = {};
+
+    if (SendOverChannels(sender_message) != 1 || SendThroughArena(size) != 1 ||
+        SharedBufferArena::GetInstance().GetBufferCount() != 0) {
+      fprintf(stderr, "payload of %s was not delivered\n",
+              SizeLabel(size).c_str());
+      return 1;
+    }
+
+    printf("shared buffer: %s payload, %lld rounds\n", SizeLabel(size).c_str(),
+           static_cast<long long>(rounds));
+    double channel = Measure("method channels", rounds, 1, [&] {
+      DoNotOptimize(SendOverChannels(sender_message));
+    });
+    double arena = Measure("SharedBufferArena", rounds, 1,
+                           [&] { DoNotOptimize(SendThroughArena(size)); });
+    printf("  %-40s %10.1f MB/s\n", "method channels throughput",
+           size / channel * 1e9 / (1 << 20));
+    printf("  %-40s %10.1f MB/s\n", "SharedBufferArena throughput",
+           size / arena * 1e9 / (1 << 20));
+  }
+  return 0;
+}
@@ -0,0 +1,117 @@
+// Compares WindowRegistry with the std::map<int64_t, std::shared_ptr<...>>
+// the Windows plugin used to keep its windows and window managers in, for
+// the two hot paths: looking up the manager of a method call's window and
+// visiting every manager when a global event is emitted.
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "benchmark.h"
+#include "window_registry.h"
+
+namespace {
+
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+
+struct FakeWindow {};
+
+struct FakeManager {
+  int64_t id = 0;
+};
+
+using Registry = window_manager_plus::WindowRegistry<FakeWindow, FakeManager>;
+
+constexpr size_t kLookupsPerRound = 1024;
+
+// Fills |registry| and |map| with |count| windows, the main window included.
+// Twice as many windows are created and every other one closed first, so the
+// registry reuses slots the way it does in a long running app.
+std::vector<int64_t> Populate(size_t count,
+                              Registry* registry,
+                              std::map<int64_t, std::shared_ptr<FakeManager>>*
+                                  map) {
+  std::vector<int64_t> ids = {Registry::kMainWindowId};
+  std::vector<int64_t> closed;
+  for (size_t i = 1; i < count; i++) {
+    closed.push_back(registry->Add());
+    ids.push_back(registry->Add());
+  }
+  for (int64_t id : closed) {
+    registry->Remove(id);
+  }
+  for (int64_t id : ids) {
+    auto manager = std::make_shared<FakeManager>();
+    manager->id = id;
+    registry->SetWindow(id, std::make_shared<FakeWindow>());
+    registry->SetManager(id, manager);
+    (*map)[id] = manager;
+  }
+  return ids;
+}
+
+// Returns |kLookupsPerRound| ids picked from |ids| in a fixed pseudo-random
+// order.
+std::vector<int64_t> LookupTrace(const std::vector<int64_t>& ids) {
+  std::vector<int64_t> trace;
+  uint32_t state = 12345;
+  for (size_t i = 0; i < kLookupsPerRound; i++) {
+    state = state * 1103515245 + 12345;
+    trace.push_back(ids[(state >> 16) % ids.size()]);
+  }
+  return trace;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations =
+      window_manager_plus::benchmark::ParseIterations(argc, argv, 5000);
+
+  for (size_t count : {1, 16, 256}) {
+    Registry registry;
+    std::map<int64_t, std::shared_ptr<FakeManager>> map;
+    std::vector<int64_t> ids = Populate(count, &registry, &map);
+    std::vector<int64_t> trace = LookupTrace(ids);
+
+    for (int64_t id : trace) {
+      auto manager = registry.FindManager(id);
+      if (!manager || manager != map[id] || manager->id != id) {
+        fprintf(stderr, "registry lost window %lld\n",
+                static_cast<long long>(id));
+        return 1;
+      }
+    }
+
+    printf("window registry: %zu windows, %lld rounds\n", count,
+           static_cast<long long>(iterations));
+    Measure("std::map lookup", iterations, trace.size(), [&] {
+      for (int64_t id : trace) {
+        auto it = map.find(id);
+        std::shared_ptr<FakeManager> manager =
+            it != map.end() ? it->second : nullptr;
+        DoNotOptimize(manager);
+      }
+    });
+    Measure("WindowRegistry lookup", iterations, trace.size(), [&] {
+      for (int64_t id : trace) {
+        DoNotOptimize(registry.FindManager(id));
+      }
+    });
+    Measure("std::map iteration", iterations, ids.size(), [&] {
+      for (const auto& entry : map) {
+        DoNotOptimize(entry.second->id);
+      }
+    });
+    Measure("WindowRegistry iteration", iterations, ids.size(), [&] {
+      registry.ForEachManager(
+          [](int64_t, const std::shared_ptr<FakeManager>& manager) {
+            DoNotOptimize(manager->id);
+          });
+    });
+  }
+  return 0;
+}
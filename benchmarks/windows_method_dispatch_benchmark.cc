@@ -0,0 +1,121 @@
+// Replays a method channel trace through the Windows plugin's method lookup
+// before and after the MethodDispatchTable: the original HandleMethodCall,
+// which copied the method name into a std::string and tested it with a chain
+// of std::string::compare calls, and the sorted constexpr table of
+// HandleMethodCall now.
+//
+// The table is built at compile time from kWindowMethodNames, which
+// HandleMethodCall static_asserts to be the names of its kMethods, so it has
+// the same entries in the same order as the shipped one; only the handlers
+// are stand-ins. The chain is the one the plugin had before the table, with
+// the 61 methods it had then. Calls the Windows plugin doesn't implement,
+// like grabKeyboard, miss in both.
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "benchmark.h"
+#include "method_dispatch.h"
+#include "window_method_names.h"
+
+namespace {
+
+using window_manager_plus::kWindowMethodNames;
+using window_manager_plus::MethodDispatchTable;
+using window_manager_plus::benchmark::DoNotOptimize;
+using window_manager_plus::benchmark::Measure;
+
+// The methods in the order the original compare chain tested them.
+constexpr const char* kChainMethods[] = {
+    "ensureInitialized", "invokeMethodToWindow", "waitUntilReadyToShow",
+    "setAsFrameless", "destroy", "close", "isPreventClose", "setPreventClose",
+    "focus", "blur", "isFocused", "show", "hide", "isVisible", "isMaximized",
+    "maximize", "unmaximize", "isMinimized", "minimize", "restore",
+    "isDockable", "isDocked", "dock", "undock", "isFullScreen",
+    "setFullScreen", "setAspectRatio", "setBackgroundColor", "getBounds",
+    "setBounds", "setMinimumSize", "setMaximumSize", "isResizable",
+    "setResizable", "isMinimizable", "setMinimizable", "isMaximizable",
+    "setMaximizable", "isClosable", "setClosable", "isAlwaysOnTop",
+    "setAlwaysOnTop", "isAlwaysOnBottom", "setAlwaysOnBottom", "getTitle",
+    "setTitle", "setTitleBarStyle", "getTitleBarHeight", "isSkipTaskbar",
+    "setSkipTaskbar", "setProgressBar", "setIcon", "hasShadow",
+    "setHasShadow", "getOpacity", "setOpacity", "setBrightness",
+    "setIgnoreMouseEvents", "popUpWindowMenu", "startDragging",
+    "startResizing",
+};
+
+constexpr size_t kChainMethodCount =
+    sizeof(kChainMethods) / sizeof(*kChainMethods);
+constexpr size_t kMethodCount =
+    sizeof(kWindowMethodNames) / sizeof(*kWindowMethodNames);
+
+// A handler stands in for a method by pointing at its name.
+using Handler = const std::string_view*;
+
+template <size_t... I>
+constexpr MethodDispatchTable<Handler, kMethodCount> MakeTable(
+    std::index_sequence<I...>) {
+  return MethodDispatchTable<Handler, kMethodCount>(
+      {{kWindowMethodNames[I], &kWindowMethodNames[I]}...});
+}
+
+constexpr auto kMethods = MakeTable(std::make_index_sequence<kMethodCount>());
+static_assert(kMethods.IsSorted(), "kMethods must be sorted by method name");
+
+// The lookup of the original HandleMethodCall, which started with
+// std::string method_name = method_call.method_name().
+const char* ChainLookup(const std::string& name) {
+  std::string method_name = name;
+  for (size_t i = 0; i < kChainMethodCount; i++) {
+    if (method_name.compare(kChainMethods[i]) == 0) {
+      return kChainMethods[i];
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int64_t iterations =
+      window_manager_plus::benchmark::ParseIterations(argc, argv, 20000);
+  std::vector<std::string> trace = window_manager_plus::benchmark::LoadTrace(
+      std::string(TRACE_DIR) + "/method_calls.txt");
+
+  // Both have to find the same method, or neither.
+  size_t misses = 0;
+  for (const std::string& method : trace) {
+    const char* chain = ChainLookup(method);
+    Handler table = kMethods.Find(method);
+    if ((chain == nullptr) != (table == nullptr) ||
+        (table != nullptr && *table != chain)) {
+      fprintf(stderr, "lookups disagree on %s\n", method.c_str());
+      return 1;
+    }
+    if (table == nullptr) {
+      misses++;
+    }
+  }
+
+  printf("windows method dispatch: %zu calls (%zu not implemented), "
+         "%zu chain methods, %zu table methods, %lld rounds\n",
+         trace.size(), misses, kChainMethodCount, kMethodCount,
+         static_cast<long long>(iterations));
+  double chain = Measure("std::string copy + compare chain", iterations,
+                         trace.size(), [&] {
+                           for (const std::string& method : trace) {
+                             DoNotOptimize(ChainLookup(method));
+                           }
+                         });
+  double table = Measure("constexpr kMethods", iterations, trace.size(), [&] {
+    for (const std::string& method : trace) {
+      DoNotOptimize(kMethods.Find(method));
+    }
+  });
+  printf("  %-40s %10.1fx\n", "speedup", chain / table);
+  return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_EVENT_RING_BUFFER_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_EVENT_RING_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace window_manager_plus {
+
+// Single-producer/single-consumer queue of fixed-size event records.
+//
+// Shared by the Windows and Linux plugins. The platform thread pushes, from
+// the window proc or the GTK window signals, and the UI thread of the
+// window's engine drains through dart:ffi. Each side only writes its own
+// index, so neither takes a lock.
+template <typename Record, size_t Capacity = 256>
+class EventRingBuffer {
+ public:
+  static constexpr size_t kCapacity = Capacity;
+
+  // Returns false, dropping |record|, if the consumer is kCapacity records
+  // behind.
+  bool Push(const Record& record) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return false;
+    }
+    records_[tail % kCapacity] = record;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Copies up to |max_count| of the oldest records to |out| and returns how
+  // many were copied.
+  size_t Drain(Record* out, size_t max_count) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t available = tail_.load(std::memory_order_acquire) - head;
+    size_t count = available < max_count ? static_cast<size_t>(available)
+                                         : max_count;
+    for (size_t i = 0; i < count; i++) {
+      out[i] = records_[(head + i) % kCapacity];
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  // Kept on separate cache lines so the two threads don't share one.
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  Record records_[kCapacity];
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_EVENT_RING_BUFFER_H_
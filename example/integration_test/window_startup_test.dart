@@ -0,0 +1,82 @@
+import 'dart:io';
+
+import 'package:flutter/widgets.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:integration_test/integration_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+/// Number of windows created for the measurement.
+const int _kWindowCount = 5;
+
+/// How long a created window may take to rasterize its first frame.
+const Duration _kFirstFrameTimeout = Duration(seconds: 30);
+
+/// Measures how long a window of [WindowManagerPlus.createWindow] takes to
+/// rasterize its first frame, as reported by
+/// [WindowManagerPlus.getWindowPoolMetrics], on Windows and Linux alike.
+Future<void> main(List<String> args) async {
+  final int windowId = args.isEmpty ? 0 : int.parse(args[0]);
+  if (windowId != 0) {
+    // Created windows run this entrypoint too; they only need a frame.
+    WidgetsFlutterBinding.ensureInitialized();
+    await WindowManagerPlus.ensureInitialized(windowId);
+    runApp(const ColoredBox(color: Color(0xFF2196F3)));
+    return;
+  }
+
+  final IntegrationTestWidgetsFlutterBinding binding =
+      IntegrationTestWidgetsFlutterBinding.ensureInitialized();
+  await WindowManagerPlus.ensureInitialized(0);
+
+  testWidgets(
+    'time to first frame of created windows',
+    (tester) async {
+      final List<double> timesMs =
+          await tester.runAsync(_measure) ?? <double>[];
+      expect(timesMs, hasLength(_kWindowCount));
+
+      final double averageMs = timesMs.reduce((a, b) => a + b) / timesMs.length;
+      binding.reportData = <String, dynamic>{
+        'timeToFirstFrameMs': timesMs,
+        'averageTimeToFirstFrameMs': averageMs,
+      };
+      // ignore: avoid_print
+      print('time to first frame: ${timesMs.join(', ')} ms, '
+          'average ${averageMs.toStringAsFixed(1)} ms');
+    },
+    skip: Platform.isMacOS,
+  );
+}
+
+/// Creates [_kWindowCount] windows one after the other and returns the time
+/// each took to its first frame in milliseconds.
+///
+/// The plugin only reports the running average, so the time of the n-th
+/// window is recovered from the averages before and after it.
+Future<List<double>> _measure() async {
+  final List<double> timesMs = [];
+  double average = await _unpooledAverageMs();
+  for (int i = 1; i <= _kWindowCount; i++) {
+    final WindowManagerPlus? window = await WindowManagerPlus.createWindow();
+    expect(window, isNotNull);
+
+    final Stopwatch waited = Stopwatch()..start();
+    double next = average;
+    while (next == average) {
+      expect(waited.elapsed, lessThan(_kFirstFrameTimeout));
+      await Future<void>.delayed(const Duration(milliseconds: 10));
+      next = await _unpooledAverageMs();
+    }
+    timesMs.add(next * i - average * (i - 1));
+    average = next;
+
+    await window!.destroy();
+  }
+  return timesMs;
+}
+
+Future<double> _unpooledAverageMs() async {
+  final WindowPoolMetrics metrics =
+      await WindowManagerPlus.getWindowPoolMetrics();
+  return metrics.unpooledTimeToFirstFrame.inMicroseconds / 1000;
+}
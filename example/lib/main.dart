@@ -6,12 +6,13 @@ import 'package:window_manager_plus_example/pages/home.dart';
 import 'package:window_manager_plus_example/utils/config.dart';
 
 void main(List<String> args) async {
+  WidgetsFlutterBinding.ensureInitialized();
+
+  args = await WindowManagerPlus.resolveEntrypointArguments(args);
   if (kDebugMode) {
     print(args);
   }
 
-  WidgetsFlutterBinding.ensureInitialized();
-
   final windowId = args.isEmpty ? 0 : int.tryParse(args[0]) ?? 0;
   await WindowManagerPlus.ensureInitialized(windowId);
 
@@ -5,6 +5,8 @@
 #include <gdk/gdkx.h>
 #endif
 
+#include <window_manager_plus/window_manager_plus_plugin.h>
+
 #include "flutter/generated_plugin_registrant.h"
 
 struct _MyApplication {
@@ -14,6 +16,31 @@ struct _MyApplication {
 
 G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
 
+// The application the windows of WindowManagerPlus.createWindow belong to.
+static GtkApplication* window_application = nullptr;
+
+// Creates the window and engine of WindowManagerPlus.createWindow.
+static GtkWindow* create_window(gchar** dart_entrypoint_arguments) {
+  GtkWindow* window =
+      GTK_WINDOW(gtk_application_window_new(window_application));
+  gtk_window_set_title(window, "window_manager_example");
+  gtk_window_set_default_size(window, 1280, 720);
+  gtk_widget_realize(GTK_WIDGET(window));
+
+  g_autoptr(FlDartProject) project = fl_dart_project_new();
+  fl_dart_project_set_dart_entrypoint_arguments(project,
+                                                dart_entrypoint_arguments);
+
+  FlView* view = fl_view_new(project);
+  gtk_widget_show(GTK_WIDGET(view));
+  gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(view));
+
+  fl_register_plugins(FL_PLUGIN_REGISTRY(view));
+
+  gtk_widget_grab_focus(GTK_WIDGET(view));
+  return window;
+}
+
 // Implements GApplication::activate.
 static void my_application_activate(GApplication* application) {
   MyApplication* self = MY_APPLICATION(application);
@@ -61,6 +88,9 @@ static void my_application_activate(GApplication* application) {
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
 
   gtk_widget_grab_focus(GTK_WIDGET(view));
+
+  window_application = GTK_APPLICATION(application);
+  window_manager_plus_plugin_set_window_created_callback(create_window);
 }
 
 // Implements GApplication::local_command_line.
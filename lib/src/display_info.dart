@@ -0,0 +1,51 @@
+import 'dart:ui';
+
+/// A display as reported by `WindowManagerPlus.getDisplays`, in logical
+/// pixels of its own [scaleFactor].
+class DisplayInfo {
+  const DisplayInfo({
+    required this.id,
+    required this.bounds,
+    required this.visibleBounds,
+    required this.scaleFactor,
+    required this.refreshRate,
+    required this.isPrimary,
+    required this.hasCursor,
+  });
+
+  factory DisplayInfo.fromJson(Map<String, dynamic> json) {
+    return DisplayInfo(
+      id: json['id'],
+      bounds: Rect.fromLTWH(
+        json['x'],
+        json['y'],
+        json['width'],
+        json['height'],
+      ),
+      visibleBounds: Rect.fromLTWH(
+        json['visibleX'],
+        json['visibleY'],
+        json['visibleWidth'],
+        json['visibleHeight'],
+      ),
+      scaleFactor: json['scaleFactor'],
+      refreshRate: json['refreshRate'],
+      isPrimary: json['isPrimary'],
+      hasCursor: json['hasCursor'],
+    );
+  }
+
+  final String id;
+  final Rect bounds;
+
+  /// The work area, [bounds] without the taskbar and docked app bars.
+  final Rect visibleBounds;
+  final double scaleFactor;
+
+  /// In Hz, 0 if unknown.
+  final int refreshRate;
+  final bool isPrimary;
+
+  /// Whether the mouse cursor was on this display.
+  final bool hasCursor;
+}
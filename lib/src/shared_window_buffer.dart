@@ -0,0 +1,86 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:window_manager_plus/src/utils/native_library.dart';
+
+final int Function(int) _allocateBuffer =
+    nativeLibrary.lookupFunction<Int64 Function(Int64), int Function(int)>(
+        'WindowManagerPlusPluginAllocateBuffer');
+final Pointer<Uint8> Function(int) _getBufferData =
+    nativeLibrary.lookupFunction<Pointer<Uint8> Function(Int64),
+        Pointer<Uint8> Function(int)>('WindowManagerPlusPluginGetBufferData');
+final int Function(int) _getBufferSize =
+    nativeLibrary.lookupFunction<Int64 Function(Int64), int Function(int)>(
+        'WindowManagerPlusPluginGetBufferSize');
+final bool Function(int) _retainBuffer =
+    nativeLibrary.lookupFunction<Bool Function(Int64), bool Function(int)>(
+        'WindowManagerPlusPluginRetainBuffer');
+final Pointer<NativeFinalizerFunction> _releaseBufferPointer =
+    nativeLibrary.lookup<NativeFinalizerFunction>(
+        'WindowManagerPlusPluginReleaseBuffer');
+final void Function(Pointer<Void>) _releaseBuffer =
+    _releaseBufferPointer.asFunction<void Function(Pointer<Void>)>();
+final NativeFinalizer _finalizer = NativeFinalizer(_releaseBufferPointer);
+
+/// A block of bytes shared by the windows of the app without copying.
+///
+/// Fill [bytes] and pass the buffer as the arguments of
+/// `invokeMethodToWindow`. The target window's
+/// [WindowListener.onEventFromWindow] receives a [SharedWindowBuffer] whose
+/// [bytes] view the same memory, so only the buffer id crosses the method
+/// channel.
+///
+/// The memory is freed once every window holding the buffer has called
+/// [release] or let its [SharedWindowBuffer] be garbage collected. [bytes]
+/// must not be used after that, so keep the [SharedWindowBuffer] itself
+/// reachable while reading or writing them.
+///
+/// **Supported Platforms**:
+/// - Windows
+class SharedWindowBuffer implements Finalizable {
+  SharedWindowBuffer._(this.id)
+      : bytes = _getBufferData(id).asTypedList(_getBufferSize(id)) {
+    _finalizer.attach(this, Pointer.fromAddress(id),
+        detach: this, externalSize: bytes.length);
+  }
+
+  /// Allocates a zero-filled buffer of [length] bytes.
+  factory SharedWindowBuffer.allocate(int length) {
+    final int id = _allocateBuffer(length);
+    if (id == 0) throw OutOfMemoryError();
+    return SharedWindowBuffer._(id);
+  }
+
+  /// The id of the buffer, the same in every window.
+  final int id;
+
+  /// The contents of the buffer.
+  final Uint8List bytes;
+
+  bool _isReleased = false;
+
+  /// Drops this window's reference to the buffer.
+  void release() {
+    if (_isReleased) return;
+    _isReleased = true;
+    _finalizer.detach(this);
+    _releaseBuffer(Pointer.fromAddress(id));
+  }
+}
+
+/// Adds the reference the window [buffer] is sent to takes over with
+/// [adoptSharedWindowBuffer].
+void retainSharedWindowBuffer(SharedWindowBuffer buffer) {
+  _retainBuffer(buffer.id);
+}
+
+/// Drops a reference added by [retainSharedWindowBuffer] that was never
+/// adopted.
+void releaseSharedWindowBuffer(int id) {
+  _releaseBuffer(Pointer.fromAddress(id));
+}
+
+/// Wraps the buffer [id] sent by another window.
+SharedWindowBuffer adoptSharedWindowBuffer(int id) {
+  return SharedWindowBuffer._(id);
+}
@@ -0,0 +1,24 @@
+/// TaskbarMetrics
+class TaskbarMetrics {
+  const TaskbarMetrics({
+    required this.creationTime,
+    required this.creationCount,
+  });
+
+  factory TaskbarMetrics.fromJson(Map<String, dynamic> json) {
+    return TaskbarMetrics(
+      creationTime: Duration(
+        microseconds: (json['creationTime'] * 1000).round(),
+      ),
+      creationCount: json['creationCount'],
+    );
+  }
+
+  /// Time spent creating the taskbar list shared by all windows, which
+  /// happens when a window first changes its taskbar button.
+  final Duration creationTime;
+
+  /// How many times the shared taskbar list was created. It is released
+  /// with the last window, and created again if needed.
+  final int creationCount;
+}
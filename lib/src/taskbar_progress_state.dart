@@ -0,0 +1,18 @@
+/// The state of the taskbar progress bar, see
+/// `WindowManagerPlus.setProgressBar`.
+enum TaskbarProgressState {
+  /// No progress is shown.
+  none,
+
+  /// The bar cycles without showing a value.
+  indeterminate,
+
+  /// The bar shows the value in the default color.
+  normal,
+
+  /// The bar shows the value in red.
+  error,
+
+  /// The bar shows the value in yellow.
+  paused,
+}
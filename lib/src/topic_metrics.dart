@@ -0,0 +1,30 @@
+/// TopicMetrics
+class TopicMetrics {
+  const TopicMetrics({
+    required this.subscribers,
+    required this.published,
+    required this.delivered,
+    required this.coalesced,
+  });
+
+  factory TopicMetrics.fromJson(Map<String, dynamic> json) {
+    return TopicMetrics(
+      subscribers: json['subscribers'],
+      published: json['published'],
+      delivered: json['delivered'],
+      coalesced: json['coalesced'],
+    );
+  }
+
+  /// The number of windows subscribed to the topic.
+  final int subscribers;
+
+  /// `publishTopic` calls for the topic.
+  final int published;
+
+  /// Messages delivered to subscribed windows, one per window.
+  final int delivered;
+
+  /// Publishes replaced by a later one within the coalescing interval.
+  final int coalesced;
+}
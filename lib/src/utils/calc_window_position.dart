@@ -1,10 +1,20 @@
+import 'dart:io';
+
 import 'package:flutter/material.dart';
 import 'package:screen_retriever/screen_retriever.dart';
+import 'package:window_manager_plus/src/display_info.dart';
+import 'package:window_manager_plus/src/window_manager.dart';
+
+Future<Rect> _calcVisibleBounds() async {
+  if (Platform.isWindows) {
+    List<DisplayInfo> displays = await WindowManagerPlus.getDisplays();
+    DisplayInfo currentDisplay = displays.firstWhere(
+      (display) => display.hasCursor,
+      orElse: () => displays.firstWhere((display) => display.isPrimary),
+    );
+    return currentDisplay.visibleBounds;
+  }
 
-Future<Offset> calcWindowPosition(
-  Size windowSize,
-  Alignment alignment,
-) async {
   Display primaryDisplay = await screenRetriever.getPrimaryDisplay();
   List<Display> allDisplays = await screenRetriever.getAllDisplays();
   Offset cursorScreenPoint = await screenRetriever.getCursorScreenPoint();
@@ -32,6 +42,24 @@ Future<Offset> calcWindowPosition(
     visibleStartX = currentDisplay.visiblePosition!.dx;
     visibleStartY = currentDisplay.visiblePosition!.dy;
   }
+  return Rect.fromLTWH(
+    visibleStartX.toDouble(),
+    visibleStartY.toDouble(),
+    visibleWidth.toDouble(),
+    visibleHeight.toDouble(),
+  );
+}
+
+Future<Offset> calcWindowPosition(
+  Size windowSize,
+  Alignment alignment,
+) async {
+  Rect visibleBounds = await _calcVisibleBounds();
+  num visibleWidth = visibleBounds.width;
+  num visibleHeight = visibleBounds.height;
+  num visibleStartX = visibleBounds.left;
+  num visibleStartY = visibleBounds.top;
+
   Offset position = const Offset(0, 0);
 
   if (alignment == Alignment.topLeft) {
@@ -0,0 +1,8 @@
+import 'dart:ffi';
+import 'dart:io';
+
+/// The plugin's native library, for the entry points called through
+/// `dart:ffi` instead of the method channel.
+final DynamicLibrary nativeLibrary = Platform.isWindows
+    ? DynamicLibrary.open('window_manager_plus_plugin.dll')
+    : DynamicLibrary.process();
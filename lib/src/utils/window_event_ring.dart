@@ -0,0 +1,156 @@
+import 'dart:ffi';
+
+import 'package:window_manager_plus/src/utils/native_library.dart';
+import 'package:window_manager_plus/src/window_manager.dart';
+
+// Must match WINDOW_MANAGER_PLUS_EVENT_* in the native plugin headers.
+const int _kEventMove = 1;
+const int _kEventResize = 2;
+
+// The capacity of the native ring, so one drain empties it.
+const int _kCapacity = 256;
+
+/// Mirrors `WindowManagerPlusEvent` of the native plugin headers.
+final class _WindowManagerPlusEvent extends Struct {
+  @Int32()
+  external int eventId;
+
+  @Int32()
+  external int reserved;
+
+  @Int64()
+  external int windowId;
+
+  @Int64()
+  external int timestampUs;
+
+  @Double()
+  external double x;
+
+  @Double()
+  external double y;
+
+  @Double()
+  external double width;
+
+  @Double()
+  external double height;
+}
+
+typedef _DrainEventsNative = Int32 Function(
+    Int64 windowId, Pointer<_WindowManagerPlusEvent> out, Int32 capacity);
+typedef _DrainEvents = int Function(
+    int windowId, Pointer<_WindowManagerPlusEvent> out, int capacity);
+typedef _AllocateEventsNative = Pointer<_WindowManagerPlusEvent> Function(
+    Int32 capacity);
+typedef _AllocateEvents = Pointer<_WindowManagerPlusEvent> Function(
+    int capacity);
+
+final _DrainEvents _drainEvents =
+    nativeLibrary.lookupFunction<_DrainEventsNative, _DrainEvents>(
+        'WindowManagerPlusPluginDrainEvents');
+final _AllocateEvents _allocateEvents =
+    nativeLibrary.lookupFunction<_AllocateEventsNative, _AllocateEvents>(
+        'WindowManagerPlusPluginAllocateEvents');
+final Pointer<NativeFinalizerFunction> _freeEventsPointer =
+    nativeLibrary.lookup<NativeFinalizerFunction>(
+        'WindowManagerPlusPluginFreeEvents');
+final void Function(Pointer<Void>) _freeEvents =
+    _freeEventsPointer.asFunction<void Function(Pointer<Void>)>();
+final NativeFinalizer _finalizer = NativeFinalizer(_freeEventsPointer);
+
+/// An event the native side recorded in a window's ring buffer.
+class WindowRingEvent {
+  const WindowRingEvent({
+    required this.eventId,
+    required this.windowId,
+    required this.timestampUs,
+    required this.x,
+    required this.y,
+    required this.width,
+    required this.height,
+  });
+
+  /// One of the `WINDOW_MANAGER_PLUS_EVENT_*` ids of the native headers.
+  final int eventId;
+
+  /// The window the event was recorded for.
+  final int windowId;
+
+  /// When the event was recorded, in microseconds on a monotonic clock.
+  final int timestampUs;
+
+  /// The window bounds when the event was recorded, in physical pixels on
+  /// Windows and logical pixels on Linux.
+  final double x;
+
+  /// See [x].
+  final double y;
+
+  /// See [x].
+  final double width;
+
+  /// See [x].
+  final double height;
+
+  /// The window event name of [eventId], or `null` for an unknown id.
+  String? get eventName {
+    switch (eventId) {
+      case _kEventMove:
+        return kWindowEventMove;
+      case _kEventResize:
+        return kWindowEventResize;
+    }
+    return null;
+  }
+}
+
+/// Reads the `move` / `resize` events the native side records in a window's
+/// ring buffer while its event fast path is enabled.
+///
+/// The events are drained into a native buffer owned by this object, which
+/// is freed by [dispose] or once the object is garbage collected.
+class WindowEventRing implements Finalizable {
+  WindowEventRing(this.windowId) : _events = _allocateEvents(_kCapacity) {
+    if (_events == nullptr) throw OutOfMemoryError();
+    _finalizer.attach(this, _events.cast(),
+        detach: this,
+        externalSize: _kCapacity * sizeOf<_WindowManagerPlusEvent>());
+  }
+
+  /// The window whose events are drained.
+  final int windowId;
+
+  final Pointer<_WindowManagerPlusEvent> _events;
+
+  bool _isDisposed = false;
+
+  /// Returns the events recorded since the last call, oldest first.
+  List<WindowRingEvent> drain() {
+    if (_isDisposed) return const [];
+
+    final int count = _drainEvents(windowId, _events, _kCapacity);
+    final List<WindowRingEvent> events = [];
+    for (int i = 0; i < count; i++) {
+      final _WindowManagerPlusEvent event = _events[i];
+      events.add(WindowRingEvent(
+        eventId: event.eventId,
+        windowId: event.windowId,
+        timestampUs: event.timestampUs,
+        x: event.x,
+        y: event.y,
+        width: event.width,
+        height: event.height,
+      ));
+    }
+    return events;
+  }
+
+  /// Frees the native buffer. [drain] returns nothing afterwards.
+  void dispose() {
+    if (_isDisposed) return;
+    _isDisposed = true;
+    _finalizer.detach(this);
+    _freeEvents(_events.cast());
+  }
+}
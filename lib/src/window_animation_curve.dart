@@ -0,0 +1,8 @@
+/// The easing curve of an animated `setBounds`, see
+/// `WindowManagerPlus.setBounds`.
+enum WindowAnimationCurve {
+  linear,
+  easeIn,
+  easeOut,
+  easeInOut,
+}
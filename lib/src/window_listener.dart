@@ -32,6 +32,7 @@ abstract mixin class WindowListener {
   /// Emitted once when the window has finished being resized.
   ///
   /// **Supported Platforms**:
+  /// - Linux
   /// - Windows
   /// - macOS
   void onWindowResized([int? windowId]) {}
@@ -42,6 +43,7 @@ abstract mixin class WindowListener {
   /// Emitted once when the window is moved to a new position.
   ///
   /// **Supported Platforms**:
+  /// - Linux
   /// - Windows
   /// - macOS
   void onWindowMoved([int? windowId]) {}
@@ -72,4 +74,11 @@ abstract mixin class WindowListener {
       String eventName, int fromWindowId, dynamic arguments) async {
     throw UnimplementedError();
   }
+
+  /// Emitted when a window publishes [value] to a [topic] this window is
+  /// subscribed to with `WindowManagerPlus.subscribeTopic`.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  void onTopicMessage(String topic, int fromWindowId, dynamic value) {}
 }
@@ -6,11 +6,24 @@ import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
 import 'package:flutter/services.dart';
 import 'package:path/path.dart' as path;
+import 'package:window_manager_plus/src/display_info.dart';
 import 'package:window_manager_plus/src/resize_edge.dart';
+import 'package:window_manager_plus/src/shared_window_buffer.dart';
+import 'package:window_manager_plus/src/taskbar_metrics.dart';
+import 'package:window_manager_plus/src/taskbar_progress_state.dart';
 import 'package:window_manager_plus/src/title_bar_style.dart';
+import 'package:window_manager_plus/src/topic_metrics.dart';
 import 'package:window_manager_plus/src/utils/calc_window_position.dart';
+import 'package:window_manager_plus/src/utils/window_event_ring.dart';
+import 'package:window_manager_plus/src/window_animation_curve.dart';
 import 'package:window_manager_plus/src/window_listener.dart';
 import 'package:window_manager_plus/src/window_options.dart';
+import 'package:window_manager_plus/src/window_placement.dart';
+import 'package:window_manager_plus/src/window_pool_metrics.dart';
+import 'package:window_manager_plus/src/window_refresh_metrics.dart';
+import 'package:window_manager_plus/src/window_refresh_mode.dart';
+import 'package:window_manager_plus/src/window_release_metrics.dart';
+import 'package:window_manager_plus/src/window_state.dart';
 
 const kWindowEventInitialized = 'initialized';
 const kWindowEventClose = 'close';
@@ -27,6 +40,7 @@ const kWindowEventMoved = 'moved';
 const kWindowEventEnterFullScreen = 'enter-full-screen';
 const kWindowEventLeaveFullScreen = 'leave-full-screen';
 const kEventFromWindow = 'event-from-window';
+const kEventTopicMessage = 'topic-message';
 
 const kWindowEventDocked = 'docked';
 const kWindowEventUndocked = 'undocked';
@@ -67,12 +81,42 @@ class WindowManagerPlus {
 
   static final Map<int, Completer> _completers = {};
 
+  Timer? _eventRingTimer;
+  WindowEventRing? _eventRing;
+
   Future<dynamic> _methodCallHandler(MethodCall call) async {
     if (call.method != 'onEvent') throw UnimplementedError();
 
     String eventName = call.arguments['eventName'];
     int? windowId = call.arguments['windowId'];
 
+    if (windowId == null && _eventRingTimer != null) {
+      // Deliver the fast path events recorded before this one first.
+      _drainEventRing();
+    }
+
+    dynamic eventArguments;
+    if (eventName == kEventFromWindow) {
+      // A SharedWindowBuffer sent with invokeMethodToWindow arrives as its id.
+      int? sharedBufferId = call.arguments['sharedBufferId'];
+      eventArguments = sharedBufferId != null
+          ? adoptSharedWindowBuffer(sharedBufferId)
+          : call.arguments['arguments'];
+    }
+
+    if (eventName == kEventTopicMessage) {
+      String topic = call.arguments['topic'];
+      int fromWindowId = call.arguments['fromWindowId'];
+      dynamic value = call.arguments['value'];
+      for (final WindowListener listener in listeners) {
+        if (!_listeners.contains(listener)) {
+          break;
+        }
+        listener.onTopicMessage(topic, fromWindowId, value);
+      }
+      return;
+    }
+
     if (windowId != null) {
       if (eventName == kWindowEventInitialized) {
         if (_completers[windowId] != null &&
@@ -123,7 +167,6 @@ class WindowManagerPlus {
           if (eventName == kEventFromWindow) {
             String method = call.arguments['method'];
             int fromWindowId = call.arguments['fromWindowId'];
-            dynamic eventArguments = call.arguments['arguments'];
             try {
               return await listener.onEventFromWindow(
                   method, fromWindowId, eventArguments);
@@ -160,7 +203,6 @@ class WindowManagerPlus {
         if (eventName == kEventFromWindow) {
           String method = call.arguments['method'];
           int fromWindowId = call.arguments['fromWindowId'];
-          dynamic eventArguments = call.arguments['arguments'];
           try {
             return await listener.onEventFromWindow(
                 method, fromWindowId, eventArguments);
@@ -190,6 +232,29 @@ class WindowManagerPlus {
     }
   }
 
+  void _drainEventRing() {
+    final WindowEventRing? eventRing = _eventRing;
+    if (eventRing == null) return;
+
+    for (final WindowRingEvent event in eventRing.drain()) {
+      final String? eventName = event.eventName;
+      if (eventName == null) continue;
+
+      for (final WindowListener listener in listeners) {
+        if (!_listeners.contains(listener)) {
+          break;
+        }
+
+        listener.onWindowEvent(eventName);
+        if (eventName == kWindowEventMove) {
+          listener.onWindowMove();
+        } else if (eventName == kWindowEventResize) {
+          listener.onWindowResize();
+        }
+      }
+    }
+  }
+
   /// Get the window listeners.
   List<WindowListener> get listeners {
     final List<WindowListener> localListeners =
@@ -234,6 +299,20 @@ class WindowManagerPlus {
     _globalListeners.remove(listener);
   }
 
+  /// Limits the global events this window receives from other windows to
+  /// [events] (e.g. `[kWindowEventInitialized, kWindowEventClose]`), so the
+  /// native side no longer sends it the rest.
+  /// Pass `null` to receive every global event again, which is the default.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<void> subscribeGlobalEvents(List<String>? events) async {
+    final Map<String, dynamic> arguments = {
+      'events': events,
+    };
+    await _invokeMethod('subscribeGlobalEvents', arguments);
+  }
+
   /// Get the device pixel ratio.
   double getDevicePixelRatio() {
     // Subsequent version, remove this deprecated member.
@@ -256,6 +335,143 @@ class WindowManagerPlus {
     return WindowManagerPlus._fromWindowId(windowId);
   }
 
+  /// Get all displays, with the one holding the mouse cursor marked, in a
+  /// single call.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  static Future<List<DisplayInfo>> getDisplays() async {
+    final List<dynamic> resultData =
+        await _staticChannel.invokeMethod('getDisplays');
+    return resultData
+        .map((display) =>
+            DisplayInfo.fromJson(Map<String, dynamic>.from(display)))
+        .toList();
+  }
+
+  /// Moves and resizes several windows at once, so they are repainted
+  /// together instead of one after the other.
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  static Future<void> applyLayout(List<WindowPlacement> layout) async {
+    final Map<String, dynamic> arguments = {
+      'devicePixelRatio': _current?.getDevicePixelRatio() ?? 1.0,
+      'layout': layout.map((placement) => placement.toJson()).toList(),
+    };
+    await _staticChannel.invokeMethod('applyLayout', arguments);
+  }
+
+  /// Keeps [size] hidden windows with a running engine ready, so that
+  /// [createWindow] can hand one out instead of starting a new engine.
+  /// Pass 0 to disable the pool, which is the default.
+  ///
+  /// Windows started by the pool must pass their entrypoint arguments through
+  /// [resolveEntrypointArguments] before reading the window id from them.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  static Future<void> setWindowPoolSize(int size) async {
+    final Map<String, dynamic> arguments = {
+      'size': size,
+    };
+    await _staticChannel.invokeMethod('setWindowPoolSize', arguments);
+  }
+
+  /// Holds the messages published to [topic] for [coalesceInterval] and only
+  /// delivers the latest one, so subscribers of a fast-changing value are
+  /// not flooded. [Duration.zero], the default, delivers every message.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  static Future<void> setTopicOptions(
+    String topic, {
+    Duration coalesceInterval = Duration.zero,
+  }) async {
+    final Map<String, dynamic> arguments = {
+      'topic': topic,
+      'coalesceInterval': coalesceInterval.inMilliseconds,
+    };
+    await _staticChannel.invokeMethod('setTopicOptions', arguments);
+  }
+
+  /// Get the subscriber count and delivery counters of every topic.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  static Future<Map<String, TopicMetrics>> getTopicMetrics() async {
+    final Map<dynamic, dynamic> resultData =
+        await _staticChannel.invokeMethod('getTopicMetrics');
+    return resultData.map(
+      (topic, metrics) => MapEntry(
+        topic as String,
+        TopicMetrics.fromJson(Map<String, dynamic>.from(metrics)),
+      ),
+    );
+  }
+
+  /// Get the hit/miss counters and time-to-first-frame of the window pool.
+  /// There is no window pool on Linux, so all of its windows count as
+  /// unpooled.
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  static Future<WindowPoolMetrics> getWindowPoolMetrics() async {
+    final Map<String, dynamic> resultData = Map<String, dynamic>.from(
+      await _staticChannel.invokeMethod('getWindowPoolMetrics'),
+    );
+    return WindowPoolMetrics.fromJson(resultData);
+  }
+
+  /// Get how often the taskbar list shared by all windows was created and
+  /// how long that took.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  static Future<TaskbarMetrics> getTaskbarMetrics() async {
+    final Map<String, dynamic> resultData = Map<String, dynamic>.from(
+      await _staticChannel.invokeMethod('getTaskbarMetrics'),
+    );
+    return TaskbarMetrics.fromJson(resultData);
+  }
+
+  /// Get how many closed windows have been released and how long they
+  /// waited for it.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  static Future<WindowReleaseMetrics> getWindowReleaseMetrics() async {
+    final Map<String, dynamic> resultData = Map<String, dynamic>.from(
+      await _staticChannel.invokeMethod('getWindowReleaseMetrics'),
+    );
+    return WindowReleaseMetrics.fromJson(resultData);
+  }
+
+  /// Returns the entrypoint arguments of this window.
+  ///
+  /// A window started by the window pool (see [setWindowPoolSize]) waits here
+  /// until [createWindow] hands it out and then gets the window id and
+  /// arguments of that call. Any other window gets [args] back unchanged.
+  static Future<List<String>> resolveEntrypointArguments(
+    List<String> args,
+  ) async {
+    if (args.length < 2 || args[0] != _kPooledWindowArgument) {
+      return args;
+    }
+    final Map<String, dynamic> arguments = {
+      'token': int.parse(args[1]),
+    };
+    // temp method channel, the window has no id yet
+    final MethodChannel _channel = const MethodChannel('window_manager_plus');
+    final List<dynamic>? resolved =
+        await _channel.invokeMethod('waitForPooledWindow', arguments);
+    return resolved?.cast<String>() ?? [];
+  }
+
+  static const _kPooledWindowArgument = '--window-manager-plus-pooled';
+
   /// Get all window manager ids.
   static Future<List<int>> getAllWindowManagerIds() async {
     return (await _staticChannel
@@ -282,6 +498,11 @@ class WindowManagerPlus {
     final MethodChannel _channel = const MethodChannel('window_manager_plus');
     await _channel.invokeMethod('ensureInitialized', arguments);
     _current = WindowManagerPlus._(windowId);
+    if (Platform.isWindows || Platform.isLinux) {
+      WidgetsBinding.instance.waitUntilFirstFrameRasterized.then((_) {
+        _current?._invokeMethod('firstFrameRasterized');
+      });
+    }
   }
 
   Future<T?> _invokeMethod<T>(String method,
@@ -564,12 +785,35 @@ class WindowManagerPlus {
     );
   }
 
+  /// Returns the bounds, the is* flags and the opacity of the window in one
+  /// call, instead of one platform channel round trip each.
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  Future<WindowState> getWindowState() async {
+    final Map<String, dynamic> arguments = {
+      'devicePixelRatio': getDevicePixelRatio(),
+    };
+    final Map<dynamic, dynamic> resultData = await _invokeMethod(
+      'getWindowState',
+      arguments,
+    );
+    return WindowState.fromJson(Map<String, dynamic>.from(resultData));
+  }
+
   /// Resizes and moves the window to the supplied bounds.
+  ///
+  /// On Linux and Windows, `animate` moves the window natively over
+  /// [animationDuration] along [animationCurve], and emits a single `moved`
+  /// and/or `resized` event when it is done.
   Future<void> setBounds(
     Rect? bounds, {
     Offset? position,
     Size? size,
     bool animate = false,
+    Duration animationDuration = const Duration(milliseconds: 200),
+    WindowAnimationCurve animationCurve = WindowAnimationCurve.easeInOut,
   }) async {
     final Map<String, dynamic> arguments = {
       'devicePixelRatio': getDevicePixelRatio(),
@@ -578,6 +822,8 @@ class WindowManagerPlus {
       'width': bounds?.size.width ?? size?.width,
       'height': bounds?.size.height ?? size?.height,
       'animate': animate,
+      'animationDuration': animate ? animationDuration.inMilliseconds : null,
+      'animationCurve': animate ? animationCurve.name : null,
     }..removeWhere((key, value) => value == null);
     await _invokeMethod('setBounds', arguments);
   }
@@ -632,6 +878,36 @@ class WindowManagerPlus {
     await _invokeMethod('setMaximumSize', arguments);
   }
 
+  /// Sets the minimum size, maximum size, aspect ratio and, if given, the
+  /// [bounds] of the window in one call, like [setMinimumSize],
+  /// [setMaximumSize], [setAspectRatio] and [setBounds] would. Constraints
+  /// left `null` are not changed. On Linux the constraints reach the window
+  /// manager as a single geometry hints update.
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  Future<void> setWindowConstraints({
+    Size? minimumSize,
+    Size? maximumSize,
+    double? aspectRatio,
+    Rect? bounds,
+  }) async {
+    final Map<String, dynamic> arguments = {
+      'devicePixelRatio': getDevicePixelRatio(),
+      'minimumWidth': minimumSize?.width,
+      'minimumHeight': minimumSize?.height,
+      'maximumWidth': maximumSize?.width,
+      'maximumHeight': maximumSize?.height,
+      'aspectRatio': aspectRatio,
+      'x': bounds?.left,
+      'y': bounds?.top,
+      'width': bounds?.width,
+      'height': bounds?.height,
+    }..removeWhere((key, value) => value == null);
+    await _invokeMethod('setWindowConstraints', arguments);
+  }
+
   /// Returns `bool` - Whether the window can be manually resized by the user.
   Future<bool> isResizable() async {
     return await _invokeMethod('isResizable');
@@ -796,19 +1072,58 @@ class WindowManagerPlus {
 
   /// Sets progress value in progress bar. Valid range is `[0, 1.0]`.
   ///
+  /// On Windows, [state] picks how the taskbar shows the bar. Without it a
+  /// [progress] below 0 hides the bar and one above 1 makes it
+  /// indeterminate. Updates that change nothing are skipped, and value
+  /// changes are applied at most once per interval, see
+  /// [setProgressBarUpdateInterval].
+  ///
   /// **Supported Platforms**:
   /// - Windows
   /// - macOS
-  Future<void> setProgressBar(double progress) async {
+  Future<void> setProgressBar(
+    double progress, {
+    TaskbarProgressState? state,
+  }) async {
     final Map<String, dynamic> arguments = {
       'progress': progress,
-    };
+      'state': state?.name,
+    }..removeWhere((key, value) => value == null);
     await _invokeMethod('setProgressBar', arguments);
   }
 
+  /// Sets the minimum interval between two progress values applied to the
+  /// taskbar by [setProgressBar]. Only the latest value set within the
+  /// interval is applied; state changes are applied right away.
+  /// Pass [Duration.zero] to apply every value. Defaults to 50ms.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<void> setProgressBarUpdateInterval(Duration interval) async {
+    final Map<String, dynamic> arguments = {
+      'interval': interval.inMilliseconds,
+    };
+    await _invokeMethod('setProgressBarUpdateInterval', arguments);
+  }
+
+  /// Returns `int` - The number of taskbar calls [setProgressBar] skipped
+  /// because they would have changed nothing or a later value replaced
+  /// them. Each [setProgressBar] stands for two calls, one for the state and
+  /// one for the value.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<int> getElidedProgressBarCallCount() async {
+    return await _invokeMethod('getElidedProgressBarCallCount');
+  }
+
   /// Sets window/taskbar icon.
   ///
+  /// The image is decoded off the platform thread and cached, so windows
+  /// showing the same icon decode it once.
+  ///
   /// **Supported Platforms**:
+  /// - Linux
   /// - Windows
   Future<void> setIcon(String iconPath) async {
     final Map<String, dynamic> arguments = {
@@ -822,6 +1137,19 @@ class WindowManagerPlus {
     await _invokeMethod('setIcon', arguments);
   }
 
+  /// Sets window/taskbar icon from the bytes of a PNG or ICO image, decoded
+  /// and cached like [setIcon].
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  Future<void> setIconFromBytes(Uint8List bytes) async {
+    final Map<String, dynamic> arguments = {
+      'iconBytes': bytes,
+    };
+    await _invokeMethod('setIcon', arguments);
+  }
+
   /// Returns `bool` - Whether the window is visible on all workspaces.
   ///
   /// **Supported Platforms**:
@@ -961,6 +1289,86 @@ class WindowManagerPlus {
     );
   }
 
+  /// Sets the minimum interval between two `move` or `resize` events emitted
+  /// while the window is being dragged or resized. Events raised within the
+  /// interval are merged so only the latest one is delivered.
+  /// Pass [Duration.zero] to receive every event. Defaults to 16ms.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<void> setEventCoalescingInterval(Duration interval) async {
+    final Map<String, dynamic> arguments = {
+      'interval': interval.inMilliseconds,
+    };
+    await _invokeMethod('setEventCoalescingInterval', arguments);
+  }
+
+  /// Sets whether this window's `move` and `resize` events skip the method
+  /// channel. When enabled, the native side records them in a ring buffer
+  /// shared with Dart, which is drained every 16ms and before any other event
+  /// of the window, so listeners still see events in order. Events of other
+  /// windows received through [addGlobalListener] are not affected.
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  Future<void> setEventFastPath(bool enabled) async {
+    if (!enabled && _eventRingTimer != null) {
+      _eventRingTimer!.cancel();
+      _eventRingTimer = null;
+      _drainEventRing();
+      _eventRing!.dispose();
+      _eventRing = null;
+    }
+    final Map<String, dynamic> arguments = {
+      'enabled': enabled,
+    };
+    await _invokeMethod('setEventFastPath', arguments);
+    if (enabled && _eventRingTimer == null) {
+      _eventRing = WindowEventRing(_id);
+      _eventRingTimer = Timer.periodic(
+        const Duration(milliseconds: 16),
+        (_) => _drainEventRing(),
+      );
+    }
+  }
+
+  /// Returns `int` - The number of `move` and `resize` events that were
+  /// merged into a later event instead of being emitted. On Linux this also
+  /// counts the window notifications dropped because nothing had changed.
+  ///
+  /// **Supported Platforms**:
+  /// - Linux
+  /// - Windows
+  Future<int> getCoalescedEventCount() async {
+    return await _invokeMethod('getCoalescedEventCount');
+  }
+
+  /// Sets how the window makes its content lay out again after a DPI change
+  /// or leaving fullscreen. Defaults to [WindowRefreshMode.frameChange].
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<void> setRefreshMode(WindowRefreshMode refreshMode) async {
+    final Map<String, dynamic> arguments = {
+      'refreshMode': refreshMode.name,
+    };
+    await _invokeMethod('setRefreshMode', arguments);
+  }
+
+  /// Get how many times the window refreshed its content and how many
+  /// surface resizes that caused.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<WindowRefreshMetrics> getRefreshMetrics() async {
+    final Map<dynamic, dynamic> resultData =
+        await _invokeMethod('getRefreshMetrics');
+    return WindowRefreshMetrics.fromJson(
+      Map<String, dynamic>.from(resultData),
+    );
+  }
+
   // /// Grabs the keyboard.
   // /// @platforms linux
   // Future<bool> grabKeyboard() async {
@@ -973,21 +1381,76 @@ class WindowManagerPlus {
   //   return await _invokeMethod('ungrabKeyboard');
   // }
 
+  /// Subscribes this window to [topic]. Messages published to it are
+  /// received by [WindowListener.onTopicMessage].
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<void> subscribeTopic(String topic) async {
+    final Map<String, dynamic> arguments = {
+      'topic': topic,
+    };
+    await _invokeMethod('subscribeTopic', arguments);
+  }
+
+  /// Unsubscribes this window from [topic].
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<void> unsubscribeTopic(String topic) async {
+    final Map<String, dynamic> arguments = {
+      'topic': topic,
+    };
+    await _invokeMethod('unsubscribeTopic', arguments);
+  }
+
+  /// Publishes [value] to every window subscribed to [topic], including this
+  /// one if it is subscribed. The native side delivers the message to each
+  /// window, so this is a single call however many windows subscribe.
+  ///
+  /// Returns `int` - The number of subscribed windows.
+  ///
+  /// **Supported Platforms**:
+  /// - Windows
+  Future<int> publishTopic(String topic, dynamic value) async {
+    final Map<String, dynamic> arguments = {
+      'topic': topic,
+      'value': value,
+    };
+    return await _invokeMethod('publishTopic', arguments);
+  }
+
   /// Invokes a method on the window with id [targetWindowId].
   /// It could return a Future that resolves to the return value of the invoked method, otherwise `null`.
   /// Use [WindowListener.onEventFromWindow] to listen for the event.
+  /// If [args] is a [SharedWindowBuffer], only its id is sent and the target
+  /// window receives a [SharedWindowBuffer] over the same memory.
   Future<dynamic> invokeMethodToWindow(int targetWindowId, String method,
       [dynamic args]) async {
+    final SharedWindowBuffer? sharedBuffer =
+        args is SharedWindowBuffer ? args : null;
     final Map<String, dynamic> arguments = {
       'targetWindowId': targetWindowId,
       'args': {
         'fromWindowId': _id,
         'eventName': kEventFromWindow,
         'method': method,
-        'arguments': args,
+        'arguments': sharedBuffer == null ? args : null,
+        if (sharedBuffer != null) 'sharedBufferId': sharedBuffer.id,
       },
     };
-    return await _invokeMethod('invokeMethodToWindow', arguments);
+    if (sharedBuffer != null) {
+      retainSharedWindowBuffer(sharedBuffer);
+    }
+    try {
+      return await _invokeMethod('invokeMethodToWindow', arguments);
+    } on PlatformException {
+      // The target window never received the buffer.
+      if (sharedBuffer != null) {
+        releaseSharedWindowBuffer(sharedBuffer.id);
+      }
+      rethrow;
+    }
   }
 
   @override
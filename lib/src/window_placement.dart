@@ -0,0 +1,30 @@
+import 'dart:ui';
+
+/// Where `WindowManagerPlus.applyLayout` puts a window.
+class WindowPlacement {
+  const WindowPlacement({
+    required this.windowId,
+    this.bounds,
+    this.zOrder,
+  });
+
+  final int windowId;
+
+  /// The new bounds of the window, or `null` to leave them unchanged.
+  final Rect? bounds;
+
+  /// Windows with a [zOrder] are stacked from the top in ascending order.
+  /// `null` leaves the window's stacking unchanged.
+  final int? zOrder;
+
+  Map<String, dynamic> toJson() {
+    return {
+      'windowId': windowId,
+      'x': bounds?.left,
+      'y': bounds?.top,
+      'width': bounds?.width,
+      'height': bounds?.height,
+      'zOrder': zOrder,
+    };
+  }
+}
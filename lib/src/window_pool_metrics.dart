@@ -0,0 +1,51 @@
+/// WindowPoolMetrics
+class WindowPoolMetrics {
+  const WindowPoolMetrics({
+    required this.size,
+    required this.ready,
+    required this.warming,
+    required this.hits,
+    required this.misses,
+    required this.pooledTimeToFirstFrame,
+    required this.unpooledTimeToFirstFrame,
+  });
+
+  factory WindowPoolMetrics.fromJson(Map<String, dynamic> json) {
+    return WindowPoolMetrics(
+      size: json['size'],
+      ready: json['ready'],
+      warming: json['warming'],
+      hits: json['hits'],
+      misses: json['misses'],
+      pooledTimeToFirstFrame: Duration(
+        microseconds: (json['pooledTimeToFirstFrame'] * 1000).round(),
+      ),
+      unpooledTimeToFirstFrame: Duration(
+        microseconds: (json['unpooledTimeToFirstFrame'] * 1000).round(),
+      ),
+    );
+  }
+
+  /// The number of windows the pool keeps ready.
+  final int size;
+
+  /// Pooled windows that can be handed out right now.
+  final int ready;
+
+  /// Pooled windows whose engine is still starting.
+  final int warming;
+
+  /// `createWindow` calls served from the pool.
+  final int hits;
+
+  /// `createWindow` calls that had to start a new engine while the pool was
+  /// enabled.
+  final int misses;
+
+  /// Average time from `createWindow` to the first frame of pooled windows.
+  final Duration pooledTimeToFirstFrame;
+
+  /// Average time from `createWindow` to the first frame of windows that
+  /// were not served from the pool.
+  final Duration unpooledTimeToFirstFrame;
+}
@@ -0,0 +1,27 @@
+/// WindowRefreshMetrics
+class WindowRefreshMetrics {
+  const WindowRefreshMetrics({
+    required this.refreshes,
+    required this.surfaceResizes,
+    required this.sizeResends,
+  });
+
+  factory WindowRefreshMetrics.fromJson(Map<String, dynamic> json) {
+    return WindowRefreshMetrics(
+      refreshes: json['refreshes'],
+      surfaceResizes: json['surfaceResizes'],
+      sizeResends: json['sizeResends'] ?? 0,
+    );
+  }
+
+  /// Times the window made its content lay out again, on DPI changes and
+  /// when leaving fullscreen.
+  final int refreshes;
+
+  /// Surface resizes of the Flutter view those refreshes caused.
+  final int surfaceResizes;
+
+  /// Refreshes that only sent the Flutter view its unchanged size again,
+  /// which does not resize its surface.
+  final int sizeResends;
+}
@@ -0,0 +1,10 @@
+/// How the window makes its content lay out again after a DPI change or
+/// leaving fullscreen, see `WindowManagerPlus.setRefreshMode`.
+enum WindowRefreshMode {
+  /// Recomputes the frame once and resizes the Flutter view at most once.
+  frameChange,
+
+  /// Resizes the Flutter view by one pixel and back. Slower, for drivers
+  /// that need a real size change to redraw.
+  nudge,
+}
@@ -0,0 +1,28 @@
+/// WindowReleaseMetrics
+class WindowReleaseMetrics {
+  const WindowReleaseMetrics({
+    required this.released,
+    required this.pending,
+    required this.averageTimeToRelease,
+  });
+
+  factory WindowReleaseMetrics.fromJson(Map<String, dynamic> json) {
+    return WindowReleaseMetrics(
+      released: json['released'],
+      pending: json['pending'],
+      averageTimeToRelease: Duration(
+        microseconds: (json['averageTimeToRelease'] * 1000).round(),
+      ),
+    );
+  }
+
+  /// Closed windows whose native resources have been released.
+  final int released;
+
+  /// Closed windows waiting to be released.
+  final int pending;
+
+  /// Average time from a window's engine shutting down to the window being
+  /// released.
+  final Duration averageTimeToRelease;
+}
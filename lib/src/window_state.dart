@@ -0,0 +1,43 @@
+import 'dart:ui';
+
+/// A snapshot of a window's bounds and state flags, see
+/// `WindowManagerPlus.getWindowState`.
+class WindowState {
+  const WindowState({
+    required this.bounds,
+    required this.isMaximized,
+    required this.isMinimized,
+    required this.isFullScreen,
+    required this.isFocused,
+    required this.isVisible,
+    required this.isAlwaysOnTop,
+    required this.opacity,
+  });
+
+  factory WindowState.fromJson(Map<String, dynamic> json) {
+    return WindowState(
+      bounds: Rect.fromLTWH(
+        json['x'],
+        json['y'],
+        json['width'],
+        json['height'],
+      ),
+      isMaximized: json['isMaximized'],
+      isMinimized: json['isMinimized'],
+      isFullScreen: json['isFullScreen'],
+      isFocused: json['isFocused'],
+      isVisible: json['isVisible'],
+      isAlwaysOnTop: json['isAlwaysOnTop'],
+      opacity: json['opacity'],
+    );
+  }
+
+  final Rect bounds;
+  final bool isMaximized;
+  final bool isMinimized;
+  final bool isFullScreen;
+  final bool isFocused;
+  final bool isVisible;
+  final bool isAlwaysOnTop;
+  final double opacity;
+}
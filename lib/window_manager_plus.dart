@@ -1,11 +1,23 @@
+export 'src/display_info.dart';
 export 'src/resize_edge.dart';
+export 'src/shared_window_buffer.dart' show SharedWindowBuffer;
+export 'src/taskbar_metrics.dart';
+export 'src/taskbar_progress_state.dart';
 export 'src/title_bar_style.dart';
+export 'src/topic_metrics.dart';
 export 'src/utils/calc_window_position.dart';
 export 'src/widgets/drag_to_move_area.dart';
 export 'src/widgets/drag_to_resize_area.dart';
 export 'src/widgets/virtual_window_frame.dart';
 export 'src/widgets/window_caption.dart';
 export 'src/widgets/window_caption_button.dart';
+export 'src/window_animation_curve.dart';
 export 'src/window_listener.dart';
 export 'src/window_manager.dart';
 export 'src/window_options.dart';
+export 'src/window_placement.dart';
+export 'src/window_pool_metrics.dart';
+export 'src/window_refresh_metrics.dart';
+export 'src/window_refresh_mode.dart';
+export 'src/window_release_metrics.dart';
+export 'src/window_state.dart';
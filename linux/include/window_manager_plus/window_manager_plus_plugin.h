@@ -0,0 +1,78 @@
+#ifndef FLUTTER_PLUGIN_WINDOW_MANAGER_PLUS_PLUGIN_H_
+#define FLUTTER_PLUGIN_WINDOW_MANAGER_PLUS_PLUGIN_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+#ifdef FLUTTER_PLUGIN_IMPL
+#define FLUTTER_PLUGIN_EXPORT __attribute__((visibility("default")))
+#else
+#define FLUTTER_PLUGIN_EXPORT
+#endif
+
+typedef struct _WindowManagerPlusPlugin WindowManagerPlusPlugin;
+typedef struct {
+  GObjectClass parent_class;
+} WindowManagerPlusPluginClass;
+
+FLUTTER_PLUGIN_EXPORT GType window_manager_plus_plugin_get_type();
+
+FLUTTER_PLUGIN_EXPORT void window_manager_plus_plugin_register_with_registrar(
+    FlPluginRegistrar* registrar);
+
+// Creates the window of a new Flutter engine for
+// WindowManagerPlus.createWindow and returns it, or null on failure.
+// |command_line_arguments| is null-terminated and only valid during the call,
+// it starts with the window id and must become the entrypoint arguments of the
+// new engine's FlDartProject.
+typedef GtkWindow* (*WindowManagerPlusPluginWindowCreatedCallback)(
+    gchar** command_line_arguments);
+
+// Sets the callback createWindow uses, without it createWindow returns null.
+FLUTTER_PLUGIN_EXPORT void
+window_manager_plus_plugin_set_window_created_callback(
+    WindowManagerPlusPluginWindowCreatedCallback callback);
+
+#define WINDOW_MANAGER_PLUS_EVENT_MOVE 1
+#define WINDOW_MANAGER_PLUS_EVENT_RESIZE 2
+
+// An event recorded by the event fast path, see
+// WindowManagerPlus.setEventFastPath. The Dart side reads this layout through
+// dart:ffi, it is the same as on Windows.
+typedef struct {
+  // One of WINDOW_MANAGER_PLUS_EVENT_*.
+  int32_t event_id;
+  int32_t reserved;
+  int64_t window_id;
+  // Microseconds of g_get_monotonic_time().
+  int64_t timestamp_us;
+  // The window bounds when the event was recorded, in logical pixels.
+  double x;
+  double y;
+  double width;
+  double height;
+} WindowManagerPlusEvent;
+
+// Moves up to |capacity| of the events recorded for |window_id| since the
+// last call into |out|, oldest first, and returns how many were moved.
+// Returns 0 if the event fast path is not enabled for the window.
+FLUTTER_PLUGIN_EXPORT int32_t
+WindowManagerPlusPluginDrainEvents(int64_t window_id,
+                                   WindowManagerPlusEvent* out,
+                                   int32_t capacity);
+
+// Returns a buffer for |capacity| events to drain into, or null on failure.
+// Free it with WindowManagerPlusPluginFreeEvents.
+FLUTTER_PLUGIN_EXPORT WindowManagerPlusEvent*
+WindowManagerPlusPluginAllocateEvents(int32_t capacity);
+
+// Frees a buffer returned by WindowManagerPlusPluginAllocateEvents. Takes a
+// void* so the Dart side can use it as a NativeFinalizer.
+FLUTTER_PLUGIN_EXPORT void WindowManagerPlusPluginFreeEvents(void* events);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_WINDOW_MANAGER_PLUS_PLUGIN_H_
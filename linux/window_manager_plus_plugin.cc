@@ -0,0 +1,2295 @@
+#include "include/window_manager_plus/window_manager_plus_plugin.h"
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+#include <math.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "event_ring_buffer.h"
+
+#define WINDOW_MANAGER_PLUS_PLUGIN(obj)                                     \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj), window_manager_plus_plugin_get_type(), \
+                              WindowManagerPlusPlugin))
+
+// The ring of the event fast path of one window.
+using WindowEventRing =
+    window_manager_plus::EventRingBuffer<WindowManagerPlusEvent>;
+
+struct _WindowManagerPlusPlugin {
+  GObject parent_instance;
+  FlPluginRegistrar* registrar;
+  // "window_manager_plus" until ensureInitialized, then
+  // "window_manager_plus_<window_id>".
+  FlMethodChannel* channel;
+  FlMethodChannel* static_channel;
+  // -1 until ensureInitialized.
+  gint64 window_id;
+  // The toplevel of the view and its GdkWindow, resolved by get_window and
+  // get_gdk_window on first use. The realize, unrealize and destroy signals
+  // of the toplevel keep them current.
+  GtkWindow* window;
+  GdkWindow* gdk_window;
+  GdkGeometry window_geometry;
+  GdkWindowHints window_hints;
+  GtkWidget* _event_box;
+  bool _is_prevent_close;
+  bool _is_frameless;
+  bool _is_always_on_top;
+  bool _is_always_on_bottom;
+  bool _is_dragging;
+  bool _is_resizing;
+  gchar* title_bar_style_;
+  GdkEventButton _event_button;
+  GdkDevice* grab_pointer;
+  GtkCssProvider* css_provider;
+  // The RGBA color loaded into css_provider, -1 if none, so setting the
+  // same color again skips parsing the CSS.
+  gint64 background_color;
+  // Animation started by setBounds with "animate", stepped by
+  // bounds_animation_tick on every frame of the window's frame clock.
+  guint bounds_animation_tick_id;
+  gint64 bounds_animation_start;
+  gint64 bounds_animation_duration;
+  GdkRectangle bounds_animation_from;
+  GdkRectangle bounds_animation_to;
+  gchar* bounds_animation_curve;
+  // When the last animation ended, 0 once the window reported its final
+  // geometry, see update_window_geometry.
+  gint64 bounds_animation_end;
+  // The geometry of the last configure notification that changed anything,
+  // see update_window_geometry.
+  GdkRectangle last_geometry;
+  bool has_last_geometry;
+  // "move" and "resize" events waiting for the next frame clock tick.
+  bool is_move_event_pending;
+  bool is_resize_event_pending;
+  guint event_coalescing_tick_id;
+  // Set by moves and resizes until "moved" and "resized" are emitted once the
+  // window stays put for kGeometryQuiescenceMs.
+  bool is_moving;
+  bool is_resizing;
+  guint geometry_quiescence_source_id;
+  // Notifications merged into a pending event or dropped because they
+  // changed nothing.
+  gint64 coalesced_event_count;
+  // The icon_cache key setIcon is decoding, nullptr once it is shown.
+  gchar* pending_icon_key;
+  // Set while the event fast path is enabled, owned by event_rings.
+  WindowEventRing* event_ring_;
+};
+
+// Every engine of the process registers its own plugin, so the windows find
+// each other through these. They are only touched from the GTK main thread.
+//
+// The plugins that called ensureInitialized, by window id.
+static std::map<gint64, WindowManagerPlusPlugin*> window_plugins;
+// The windows made by createWindow that are still open, by window id.
+static std::map<gint64, GtkWindow*> created_windows;
+static gint64 next_window_id = 1;
+static WindowManagerPlusPluginWindowCreatedCallback window_created_callback =
+    nullptr;
+// When createWindow was called, for the windows that have not rasterized
+// their first frame yet. Feeds getWindowPoolMetrics.
+static std::map<gint64, gint64> pending_first_frames;
+static gdouble first_frame_ms = 0;
+static gint64 first_frame_count = 0;
+// The button-press-event emission hook of on_mouse_press. Emission hooks
+// see the presses of every window, so it is added once for all plugins.
+static gulong mouse_press_hook_id = 0;
+
+// The rings of the event fast path by window id. They are also read from the
+// UI threads draining them.
+static std::mutex event_ring_mutex;
+static std::map<int64_t, std::shared_ptr<WindowEventRing>> event_rings;
+
+// The images decoded for setIcon, by icon_cache_key, so windows showing the
+// same icon decode it once. Only touched from the GTK main thread; windows
+// hold their own reference to the pixbuf they show.
+struct IconCacheEntry {
+  GdkPixbuf* pixbuf;
+  guint64 last_used;
+};
+static std::map<std::string, IconCacheEntry> icon_cache;
+static guint64 icon_cache_use_count = 0;
+static const size_t kMaxIconCacheEntries = 16;
+
+G_DEFINE_TYPE(WindowManagerPlusPlugin,
+              window_manager_plus_plugin,
+              g_object_get_type())
+
+static WindowManagerPlusPlugin* find_window_plugin(gint64 window_id) {
+  auto it = window_plugins.find(window_id);
+  return it != window_plugins.end() ? it->second : nullptr;
+}
+
+// Gets the window being controlled.
+GtkWindow* get_window(WindowManagerPlusPlugin* self) {
+  if (self->window != nullptr)
+    return self->window;
+
+  FlView* view = fl_plugin_registrar_get_view(self->registrar);
+  if (view == nullptr)
+    return nullptr;
+
+  GtkWidget* toplevel = gtk_widget_get_toplevel(GTK_WIDGET(view));
+  // Until the view is added to a window it is its own toplevel, which is
+  // not worth keeping.
+  if (gtk_widget_is_toplevel(toplevel))
+    self->window = GTK_WINDOW(toplevel);
+  return GTK_WINDOW(toplevel);
+}
+
+GdkWindow* get_gdk_window(WindowManagerPlusPlugin* self) {
+  if (self->gdk_window == nullptr)
+    self->gdk_window = gtk_widget_get_window(GTK_WIDGET(get_window(self)));
+  return self->gdk_window;
+}
+
+static FlMethodResponse* set_as_frameless(WindowManagerPlusPlugin* self,
+                                          FlValue* args) {
+  gtk_window_set_decorated(get_window(self), false);
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* destroy(WindowManagerPlusPlugin* self) {
+  self->_is_prevent_close = false;
+  gtk_window_close(get_window(self));
+  return FL_METHOD_RESPONSE(
+      fl_method_success_response_new(fl_value_new_bool(true)));
+}
+
+static FlMethodResponse* close(WindowManagerPlusPlugin* self) {
+  gtk_window_close(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_prevent_close(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(self->_is_prevent_close);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_prevent_close(WindowManagerPlusPlugin* self,
+                                           FlValue* args) {
+  self->_is_prevent_close =
+      fl_value_get_bool(fl_value_lookup_string(args, "isPreventClose"));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* focus(WindowManagerPlusPlugin* self) {
+  gtk_window_present(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* blur(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_focused(WindowManagerPlusPlugin* self) {
+  bool is_focused = gtk_window_is_active(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(is_focused);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* show(WindowManagerPlusPlugin* self) {
+  gtk_widget_show(GTK_WIDGET(get_window(self)));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* hide(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  gint x, y, width, height;
+  // store the bound of window before hide
+  gtk_window_get_position(window, &x, &y);
+  gtk_window_get_size(window, &width, &height);
+  gtk_widget_hide(GTK_WIDGET(window));
+  // restore the bound of window after hide
+  gtk_window_move(window, x, y);
+  gtk_window_resize(window, width, height);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_visible(WindowManagerPlusPlugin* self) {
+  bool is_visible = gtk_widget_is_visible(GTK_WIDGET(get_window(self)));
+  g_autoptr(FlValue) result = fl_value_new_bool(is_visible);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_maximized(WindowManagerPlusPlugin* self) {
+  bool is_maximized = gtk_window_is_maximized(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(is_maximized);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* maximize(WindowManagerPlusPlugin* self) {
+  gtk_window_maximize(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* unmaximize(WindowManagerPlusPlugin* self) {
+  gtk_window_unmaximize(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_minimized(WindowManagerPlusPlugin* self) {
+  GdkWindowState state = gdk_window_get_state(get_gdk_window(self));
+  g_autoptr(FlValue) result =
+      fl_value_new_bool(state & GDK_WINDOW_STATE_ICONIFIED);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* minimize(WindowManagerPlusPlugin* self) {
+  gtk_window_iconify(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_dockable(WindowManagerPlusPlugin* self) {
+  bool is_docked = false;
+  g_autoptr(FlValue) result = fl_value_new_bool(is_docked);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_docked(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_null();
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* dock(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* undock(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* restore(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  gtk_window_deiconify(window);
+  gtk_window_present(window);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_full_screen(WindowManagerPlusPlugin* self) {
+  GdkWindowState state = gdk_window_get_state(get_gdk_window(self));
+  g_autoptr(FlValue) result =
+      fl_value_new_bool(state & GDK_WINDOW_STATE_FULLSCREEN);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_full_screen(WindowManagerPlusPlugin* self,
+                                         FlValue* args) {
+  bool is_full_screen =
+      fl_value_get_bool(fl_value_lookup_string(args, "isFullScreen"));
+
+  if (is_full_screen)
+    gtk_window_fullscreen(get_window(self));
+  else
+    gtk_window_unfullscreen(get_window(self));
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// The update_*_hint functions only change window_geometry and window_hints,
+// apply_geometry_hints sends them to the windowing system in one request.
+static void apply_geometry_hints(WindowManagerPlusPlugin* self) {
+  gdk_window_set_geometry_hints(get_gdk_window(self), &self->window_geometry,
+                                self->window_hints);
+}
+
+static void update_aspect_ratio_hint(WindowManagerPlusPlugin* self,
+                                     float aspect_ratio) {
+  self->window_geometry.min_aspect = aspect_ratio;
+  self->window_geometry.max_aspect = aspect_ratio;
+
+  if (aspect_ratio >= 0) {
+    self->window_hints =
+        static_cast<GdkWindowHints>(self->window_hints | GDK_HINT_ASPECT);
+  } else {
+    self->window_hints =
+        static_cast<GdkWindowHints>(self->window_hints & ~GDK_HINT_ASPECT);
+  }
+}
+
+static void update_minimum_size_hint(WindowManagerPlusPlugin* self,
+                                     float width,
+                                     float height) {
+  if (width >= 0 && height >= 0) {
+    self->window_geometry.min_width = static_cast<gint>(width);
+    self->window_geometry.min_height = static_cast<gint>(height);
+    self->window_hints =
+        static_cast<GdkWindowHints>(self->window_hints | GDK_HINT_MIN_SIZE);
+  } else {
+    self->window_hints =
+        static_cast<GdkWindowHints>(self->window_hints & ~GDK_HINT_MIN_SIZE);
+  }
+}
+
+static void update_maximum_size_hint(WindowManagerPlusPlugin* self,
+                                     float width,
+                                     float height) {
+  self->window_geometry.max_width = static_cast<gint>(width);
+  self->window_geometry.max_height = static_cast<gint>(height);
+
+  if (width >= 0 && height >= 0) {
+    self->window_hints =
+        static_cast<GdkWindowHints>(self->window_hints | GDK_HINT_MAX_SIZE);
+  } else {
+    self->window_hints =
+        static_cast<GdkWindowHints>(self->window_hints & ~GDK_HINT_MAX_SIZE);
+  }
+
+  if (self->window_geometry.max_width < 0)
+    self->window_geometry.max_width = G_MAXINT;
+  if (self->window_geometry.max_height < 0)
+    self->window_geometry.max_height = G_MAXINT;
+}
+
+static FlMethodResponse* set_aspect_ratio(WindowManagerPlusPlugin* self,
+                                          FlValue* args) {
+  update_aspect_ratio_hint(
+      self, fl_value_get_float(fl_value_lookup_string(args, "aspectRatio")));
+  apply_geometry_hints(self);
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_background_color(WindowManagerPlusPlugin* self,
+                                              FlValue* args) {
+  gint64 red =
+      fl_value_get_int(fl_value_lookup_string(args, "backgroundColorR"));
+  gint64 green =
+      fl_value_get_int(fl_value_lookup_string(args, "backgroundColorG"));
+  gint64 blue =
+      fl_value_get_int(fl_value_lookup_string(args, "backgroundColorB"));
+  gint64 alpha =
+      fl_value_get_int(fl_value_lookup_string(args, "backgroundColorA"));
+
+  gint64 color = (red << 24) | (green << 16) | (blue << 8) | alpha;
+  if (color == self->background_color) {
+    g_autoptr(FlValue) result = fl_value_new_bool(true);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  // g_ascii_dtostr keeps the decimal point whatever the locale.
+  gchar alpha_string[G_ASCII_DTOSTR_BUF_SIZE];
+  g_ascii_dtostr(alpha_string, sizeof(alpha_string), alpha / 255.0);
+  g_autofree gchar* css = g_strdup_printf(
+      "window { background-color: rgba(%d, %d, %d, %s); }",
+      static_cast<int>(red), static_cast<int>(green), static_cast<int>(blue),
+      alpha_string);
+
+  if (self->css_provider == nullptr) {
+    self->css_provider = gtk_css_provider_new();
+    gtk_style_context_add_provider(
+        gtk_widget_get_style_context(GTK_WIDGET(get_window(self))),
+        GTK_STYLE_PROVIDER(self->css_provider),
+        GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+  }
+
+  g_autoptr(GError) error = nullptr;
+  gtk_css_provider_load_from_data(self->css_provider, css, -1, &error);
+
+  if (error != nullptr) {
+    self->background_color = -1;
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "setBackgroundColor", error->message, nullptr));
+  }
+  self->background_color = color;
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* get_bounds(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  gint x, y, width, height;
+  gtk_window_get_position(window, &x, &y);
+  gtk_window_get_size(window, &width, &height);
+
+  g_autoptr(FlValue) result_data = fl_value_new_map();
+  fl_value_set_string_take(result_data, "x", fl_value_new_float(x));
+  fl_value_set_string_take(result_data, "y", fl_value_new_float(y));
+  fl_value_set_string_take(result_data, "width", fl_value_new_float(width));
+  fl_value_set_string_take(result_data, "height", fl_value_new_float(height));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result_data));
+}
+
+static FlMethodResponse* get_window_state(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  GdkWindowState state = gdk_window_get_state(get_gdk_window(self));
+  gint x, y, width, height;
+  gtk_window_get_position(window, &x, &y);
+  gtk_window_get_size(window, &width, &height);
+
+  g_autoptr(FlValue) result_data = fl_value_new_map();
+  fl_value_set_string_take(result_data, "x", fl_value_new_float(x));
+  fl_value_set_string_take(result_data, "y", fl_value_new_float(y));
+  fl_value_set_string_take(result_data, "width", fl_value_new_float(width));
+  fl_value_set_string_take(result_data, "height", fl_value_new_float(height));
+  fl_value_set_string_take(result_data, "isMaximized",
+                           fl_value_new_bool(gtk_window_is_maximized(window)));
+  fl_value_set_string_take(
+      result_data, "isMinimized",
+      fl_value_new_bool(state & GDK_WINDOW_STATE_ICONIFIED));
+  fl_value_set_string_take(
+      result_data, "isFullScreen",
+      fl_value_new_bool(state & GDK_WINDOW_STATE_FULLSCREEN));
+  fl_value_set_string_take(result_data, "isFocused",
+                           fl_value_new_bool(gtk_window_is_active(window)));
+  fl_value_set_string_take(
+      result_data, "isVisible",
+      fl_value_new_bool(gtk_widget_is_visible(GTK_WIDGET(window))));
+  fl_value_set_string_take(result_data, "isAlwaysOnTop",
+                           fl_value_new_bool(self->_is_always_on_top));
+  fl_value_set_string_take(
+      result_data, "opacity",
+      fl_value_new_float(gtk_widget_get_opacity(GTK_WIDGET(window))));
+
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result_data));
+}
+
+void _emit_event(WindowManagerPlusPlugin* plugin, const char* event_name);
+
+// Maps the linear progress |t| of a bounds animation onto |curve|.
+static gdouble ease_bounds_animation(const gchar* curve, gdouble t) {
+  if (g_strcmp0(curve, "linear") == 0)
+    return t;
+  if (g_strcmp0(curve, "easeIn") == 0)
+    return t * t * t;
+  if (g_strcmp0(curve, "easeOut") == 0)
+    return 1 - pow(1 - t, 3);
+  return t < 0.5 ? 4 * t * t * t : 1 - pow(-2 * t + 2, 3) / 2;
+}
+
+static gboolean bounds_animation_tick(GtkWidget* widget,
+                                      GdkFrameClock* frame_clock,
+                                      gpointer data) {
+  WindowManagerPlusPlugin* self = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  gint64 frame_time = gdk_frame_clock_get_frame_time(frame_clock);
+  if (self->bounds_animation_start == 0)
+    self->bounds_animation_start = frame_time;
+
+  gdouble t = self->bounds_animation_duration > 0
+                  ? MIN(static_cast<gdouble>(frame_time -
+                                             self->bounds_animation_start) /
+                            self->bounds_animation_duration,
+                        1.0)
+                  : 1.0;
+  gdouble progress = ease_bounds_animation(self->bounds_animation_curve, t);
+  const GdkRectangle& from = self->bounds_animation_from;
+  const GdkRectangle& to = self->bounds_animation_to;
+  auto lerp = [progress](gint from, gint to) {
+    return static_cast<gint>(round(from + (to - from) * progress));
+  };
+  GtkWindow* window = GTK_WINDOW(widget);
+  gtk_window_move(window, lerp(from.x, to.x), lerp(from.y, to.y));
+  gtk_window_resize(window, lerp(from.width, to.width),
+                    lerp(from.height, to.height));
+
+  if (t < 1.0)
+    return G_SOURCE_CONTINUE;
+
+  // Listeners only hear about the animation once, when it is over.
+  self->bounds_animation_tick_id = 0;
+  self->bounds_animation_end = g_get_monotonic_time();
+  if (from.width != to.width || from.height != to.height)
+    _emit_event(self, "resized");
+  if (from.x != to.x || from.y != to.y)
+    _emit_event(self, "moved");
+  return G_SOURCE_REMOVE;
+}
+
+static void stop_geometry_tracking(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  if (self->event_coalescing_tick_id != 0 && window != nullptr) {
+    gtk_widget_remove_tick_callback(GTK_WIDGET(window),
+                                    self->event_coalescing_tick_id);
+  }
+  self->event_coalescing_tick_id = 0;
+  self->is_move_event_pending = false;
+  self->is_resize_event_pending = false;
+  if (self->geometry_quiescence_source_id != 0)
+    g_source_remove(self->geometry_quiescence_source_id);
+  self->geometry_quiescence_source_id = 0;
+}
+
+static void stop_bounds_animation(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  if (self->bounds_animation_tick_id != 0 && window != nullptr) {
+    gtk_widget_remove_tick_callback(GTK_WIDGET(window),
+                                    self->bounds_animation_tick_id);
+  }
+  self->bounds_animation_tick_id = 0;
+  self->bounds_animation_end = 0;
+}
+
+static FlMethodResponse* set_bounds(WindowManagerPlusPlugin* self,
+                                    FlValue* args) {
+  stop_bounds_animation(self);
+
+  FlValue* animate = fl_value_lookup_string(args, "animate");
+  if (animate != nullptr && fl_value_get_bool(animate)) {
+    GtkWindow* window = get_window(self);
+    GdkRectangle& from = self->bounds_animation_from;
+    GdkRectangle& to = self->bounds_animation_to;
+    gtk_window_get_position(window, &from.x, &from.y);
+    gtk_window_get_size(window, &from.width, &from.height);
+    to = from;
+
+    FlValue* x = fl_value_lookup_string(args, "x");
+    FlValue* y = fl_value_lookup_string(args, "y");
+    if (x != nullptr && y != nullptr) {
+      to.x = static_cast<gint>(fl_value_get_float(x));
+      to.y = static_cast<gint>(fl_value_get_float(y));
+    }
+    FlValue* width = fl_value_lookup_string(args, "width");
+    FlValue* height = fl_value_lookup_string(args, "height");
+    if (width != nullptr && height != nullptr) {
+      to.width = static_cast<gint>(fl_value_get_float(width));
+      to.height = static_cast<gint>(fl_value_get_float(height));
+    }
+
+    FlValue* duration = fl_value_lookup_string(args, "animationDuration");
+    self->bounds_animation_duration =
+        (duration != nullptr ? fl_value_get_int(duration) : 200) *
+        G_TIME_SPAN_MILLISECOND;
+    FlValue* curve = fl_value_lookup_string(args, "animationCurve");
+    g_free(self->bounds_animation_curve);
+    self->bounds_animation_curve =
+        g_strdup(curve != nullptr ? fl_value_get_string(curve) : "easeInOut");
+    // The start is taken from the first frame, see bounds_animation_tick.
+    self->bounds_animation_start = 0;
+    self->bounds_animation_tick_id = gtk_widget_add_tick_callback(
+        GTK_WIDGET(window), bounds_animation_tick, self, nullptr);
+
+    g_autoptr(FlValue) result = fl_value_new_bool(true);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  }
+
+  GtkWindow* window = get_window(self);
+  FlValue* x = fl_value_lookup_string(args, "x");
+  FlValue* y = fl_value_lookup_string(args, "y");
+  if (x != nullptr && y != nullptr) {
+    gtk_window_move(window, static_cast<gint>(fl_value_get_float(x)),
+                    static_cast<gint>(fl_value_get_float(y)));
+  }
+
+  FlValue* width = fl_value_lookup_string(args, "width");
+  FlValue* height = fl_value_lookup_string(args, "height");
+  if (width != nullptr && height != nullptr) {
+    gtk_window_resize(window, static_cast<gint>(fl_value_get_float(width)),
+                      static_cast<gint>(fl_value_get_float(height)));
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Every window of the layout has its updates frozen until all entries are
+// applied, so the moves and resizes are painted together.
+static FlMethodResponse* apply_layout(WindowManagerPlusPlugin* self,
+                                     FlValue* args) {
+  FlValue* layout = fl_value_lookup_string(args, "layout");
+  std::vector<GdkWindow*> frozen_windows;
+  for (size_t i = 0; i < fl_value_get_length(layout); i++) {
+    FlValue* entry = fl_value_get_list_value(layout, i);
+    WindowManagerPlusPlugin* plugin = find_window_plugin(
+        fl_value_get_int(fl_value_lookup_string(entry, "windowId")));
+    GdkWindow* gdk_window =
+        plugin != nullptr ? get_gdk_window(plugin) : nullptr;
+    if (gdk_window != nullptr &&
+        std::find(frozen_windows.begin(), frozen_windows.end(), gdk_window) ==
+            frozen_windows.end()) {
+      gdk_window_freeze_updates(gdk_window);
+      frozen_windows.push_back(gdk_window);
+    }
+  }
+
+  for (size_t i = 0; i < fl_value_get_length(layout); i++) {
+    FlValue* entry = fl_value_get_list_value(layout, i);
+    WindowManagerPlusPlugin* plugin = find_window_plugin(
+        fl_value_get_int(fl_value_lookup_string(entry, "windowId")));
+    if (plugin == nullptr)
+      continue;
+
+    GtkWindow* window = get_window(plugin);
+    FlValue* x = fl_value_lookup_string(entry, "x");
+    FlValue* y = fl_value_lookup_string(entry, "y");
+    if (x != nullptr && fl_value_get_type(x) == FL_VALUE_TYPE_FLOAT &&
+        y != nullptr && fl_value_get_type(y) == FL_VALUE_TYPE_FLOAT) {
+      gtk_window_move(window, static_cast<gint>(fl_value_get_float(x)),
+                      static_cast<gint>(fl_value_get_float(y)));
+    }
+    FlValue* width = fl_value_lookup_string(entry, "width");
+    FlValue* height = fl_value_lookup_string(entry, "height");
+    if (width != nullptr && fl_value_get_type(width) == FL_VALUE_TYPE_FLOAT &&
+        height != nullptr &&
+        fl_value_get_type(height) == FL_VALUE_TYPE_FLOAT) {
+      gtk_window_resize(window, static_cast<gint>(fl_value_get_float(width)),
+                        static_cast<gint>(fl_value_get_float(height)));
+    }
+  }
+
+  for (GdkWindow* gdk_window : frozen_windows)
+    gdk_window_thaw_updates(gdk_window);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_minimum_size(WindowManagerPlusPlugin* self,
+                                          FlValue* args) {
+  const float width = fl_value_get_float(fl_value_lookup_string(args, "width"));
+  const float height =
+      fl_value_get_float(fl_value_lookup_string(args, "height"));
+  update_minimum_size_hint(self, width, height);
+  apply_geometry_hints(self);
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_maximum_size(WindowManagerPlusPlugin* self,
+                                          FlValue* args) {
+  const float width = fl_value_get_float(fl_value_lookup_string(args, "width"));
+  const float height =
+      fl_value_get_float(fl_value_lookup_string(args, "height"));
+  update_maximum_size_hint(self, width, height);
+  apply_geometry_hints(self);
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Applies the minimum size, maximum size and aspect ratio present in |args|
+// as a single geometry hints update, then the bounds if there are any.
+static FlMethodResponse* set_window_constraints(WindowManagerPlusPlugin* self,
+                                                FlValue* args) {
+  FlValue* minimum_width = fl_value_lookup_string(args, "minimumWidth");
+  FlValue* minimum_height = fl_value_lookup_string(args, "minimumHeight");
+  if (minimum_width != nullptr && minimum_height != nullptr) {
+    update_minimum_size_hint(self, fl_value_get_float(minimum_width),
+                             fl_value_get_float(minimum_height));
+  }
+  FlValue* maximum_width = fl_value_lookup_string(args, "maximumWidth");
+  FlValue* maximum_height = fl_value_lookup_string(args, "maximumHeight");
+  if (maximum_width != nullptr && maximum_height != nullptr) {
+    update_maximum_size_hint(self, fl_value_get_float(maximum_width),
+                             fl_value_get_float(maximum_height));
+  }
+  FlValue* aspect_ratio = fl_value_lookup_string(args, "aspectRatio");
+  if (aspect_ratio != nullptr)
+    update_aspect_ratio_hint(self, fl_value_get_float(aspect_ratio));
+  apply_geometry_hints(self);
+
+  if (fl_value_lookup_string(args, "x") != nullptr ||
+      fl_value_lookup_string(args, "width") != nullptr) {
+    return set_bounds(self, args);
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_resizable(WindowManagerPlusPlugin* self) {
+  bool is_resizable = gtk_window_get_resizable(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(is_resizable);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_resizable(WindowManagerPlusPlugin* self,
+                                       FlValue* args) {
+  bool is_resizable =
+      fl_value_get_bool(fl_value_lookup_string(args, "isResizable"));
+  gtk_window_set_resizable(get_window(self), is_resizable);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_minimizable(WindowManagerPlusPlugin* self) {
+  GdkWindowState state = gdk_window_get_state(get_gdk_window(self));
+  GdkWindowTypeHint type_hint = gtk_window_get_type_hint(get_window(self));
+  g_autoptr(FlValue) result =
+      fl_value_new_bool(!(state & GDK_WINDOW_STATE_ICONIFIED) &&
+                        type_hint == GDK_WINDOW_TYPE_HINT_NORMAL);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_minimizable(WindowManagerPlusPlugin* self,
+                                         FlValue* args) {
+  gboolean minimizable =
+      fl_value_get_bool(fl_value_lookup_string(args, "isMinimizable"));
+  GdkWindowTypeHint type_hint =
+      minimizable ? GDK_WINDOW_TYPE_HINT_NORMAL : GDK_WINDOW_TYPE_HINT_DIALOG;
+  gtk_window_set_type_hint(get_window(self), type_hint);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+static FlMethodResponse* is_maximizable(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  gboolean resizable = gtk_window_get_resizable(window);
+  GdkWindowState state = gdk_window_get_state(get_gdk_window(self));
+  GdkWindowTypeHint type_hint = gtk_window_get_type_hint(window);
+  g_autoptr(FlValue) result =
+      fl_value_new_bool(resizable && !(state & GDK_WINDOW_STATE_MAXIMIZED) &&
+                        type_hint == GDK_WINDOW_TYPE_HINT_NORMAL);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_maximizable(WindowManagerPlusPlugin* self,
+                                         FlValue* args) {
+  gboolean maximizable =
+      fl_value_get_bool(fl_value_lookup_string(args, "isMaximizable"));
+  GdkWindowTypeHint type_hint =
+      maximizable ? GDK_WINDOW_TYPE_HINT_NORMAL : GDK_WINDOW_TYPE_HINT_DIALOG;
+  gtk_window_set_type_hint(get_window(self), type_hint);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+}
+
+static FlMethodResponse* is_closable(WindowManagerPlusPlugin* self) {
+  bool is_closable = gtk_window_get_deletable(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(is_closable);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_closable(WindowManagerPlusPlugin* self,
+                                      FlValue* args) {
+  bool is_closable =
+      fl_value_get_bool(fl_value_lookup_string(args, "isClosable"));
+  gtk_window_set_deletable(get_window(self), is_closable);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_always_on_top(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(self->_is_always_on_top);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_always_on_top(WindowManagerPlusPlugin* self,
+                                           FlValue* args) {
+  bool isAlwaysOnTop =
+      fl_value_get_bool(fl_value_lookup_string(args, "isAlwaysOnTop"));
+
+  gtk_window_set_keep_above(get_window(self), isAlwaysOnTop);
+  self->_is_always_on_top = isAlwaysOnTop;
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_always_on_bottom(WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(self->_is_always_on_bottom);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_always_on_bottom(WindowManagerPlusPlugin* self,
+                                              FlValue* args) {
+  bool isAlwaysOnBottom =
+      fl_value_get_bool(fl_value_lookup_string(args, "isAlwaysOnBottom"));
+
+  gtk_window_set_keep_below(get_window(self), isAlwaysOnBottom);
+  self->_is_always_on_bottom = isAlwaysOnBottom;
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* get_title(WindowManagerPlusPlugin* self) {
+  const gchar* title = gtk_window_get_title(get_window(self));
+  g_autoptr(FlValue) result =
+      fl_value_new_string(title != nullptr ? title : "");
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_title(WindowManagerPlusPlugin* self,
+                                   FlValue* args) {
+  const gchar* title =
+      fl_value_get_string(fl_value_lookup_string(args, "title"));
+
+  gtk_window_set_title(get_window(self), title);
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Returns true if the widget is GtkHeaderBar or HdyHeaderBar from libhandy.
+static gboolean is_header_bar(GtkWidget* widget) {
+  return widget != nullptr &&
+         (GTK_IS_HEADER_BAR(widget) ||
+          g_str_has_suffix(G_OBJECT_TYPE_NAME(widget), "HeaderBar"));
+}
+
+// Recursively searches for a Gtk/HdyHeaderBar in the widget tree.
+static GtkWidget* find_header_bar(GtkWidget* widget) {
+  if (is_header_bar(widget)) {
+    return widget;
+  }
+
+  if (GTK_IS_CONTAINER(widget)) {
+    g_autoptr(GList) children =
+        gtk_container_get_children(GTK_CONTAINER(widget));
+    for (GList* l = children; l != nullptr; l = l->next) {
+      GtkWidget* header_bar = find_header_bar(GTK_WIDGET(l->data));
+      if (header_bar != nullptr) {
+        return header_bar;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+// Returns the window's header bar which is typically a GtkHeaderBar used as
+// GtkWindow::titlebar, or a HdyHeaderBar as HdyWindow granchild.
+static GtkWidget* get_header_bar(GtkWindow* window) {
+  GtkWidget* titlebar = gtk_window_get_titlebar(window);
+  if (is_header_bar(titlebar)) {
+    return titlebar;
+  }
+  return find_header_bar(GTK_WIDGET(window));
+}
+
+static FlMethodResponse* set_title_bar_style(WindowManagerPlusPlugin* self,
+                                             FlValue* args) {
+  const gchar* title_bar_style =
+      fl_value_get_string(fl_value_lookup_string(args, "titleBarStyle"));
+
+  gboolean normal = g_strcmp0(title_bar_style, "hidden") != 0;
+
+  GtkWindow* window = get_window(self);
+  GtkWidget* header_bar = get_header_bar(window);
+  if (header_bar != nullptr) {
+    gtk_widget_set_visible(header_bar, normal);
+  } else {
+    const gchar* title = gtk_window_get_title(window);
+    if (title != nullptr) {
+      gtk_window_set_decorated(window, normal);
+    }
+  }
+
+  if (normal) {
+    // Undo set_as_frameless, so that when the title bar is shown
+    // again the window frame is also restored.
+    gtk_window_set_decorated(window, true);
+  }
+
+  g_free(self->title_bar_style_);
+  self->title_bar_style_ = g_strdup(title_bar_style);
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* get_title_bar_height(WindowManagerPlusPlugin* self,
+                                              FlValue* args) {
+  GtkWidget* widget = gtk_window_get_titlebar(get_window(self));
+
+  int title_bar_height = 0;
+
+  if (g_strcmp0(self->title_bar_style_, "hidden") != 0) {
+    title_bar_height = gtk_widget_get_allocated_height(widget);
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_int(title_bar_height);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* is_skip_taskbar(WindowManagerPlusPlugin* self) {
+  const gboolean skipping = gtk_window_get_skip_taskbar_hint(get_window(self));
+  g_autoptr(FlValue) result = fl_value_new_bool(skipping);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_skip_taskbar(WindowManagerPlusPlugin* self,
+                                          FlValue* args) {
+  bool isSkipTaskbar =
+      fl_value_get_bool(fl_value_lookup_string(args, "isSkipTaskbar"));
+  gtk_window_set_skip_taskbar_hint(get_window(self), isSkipTaskbar);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// What the worker thread of set_icon decodes.
+struct IconDecodeData {
+  std::string key;
+  std::string path;
+  GBytes* bytes;
+};
+
+static void icon_decode_data_free(gpointer data) {
+  IconDecodeData* decode_data = static_cast<IconDecodeData*>(data);
+  g_clear_pointer(&decode_data->bytes, g_bytes_unref);
+  delete decode_data;
+}
+
+static std::string icon_cache_key(FlValue* args) {
+  FlValue* icon_bytes = fl_value_lookup_string(args, "iconBytes");
+  if (icon_bytes != nullptr &&
+      fl_value_get_type(icon_bytes) == FL_VALUE_TYPE_UINT8_LIST) {
+    // A digest rather than a hash, so two images never share an entry.
+    g_autofree gchar* digest = g_compute_checksum_for_data(
+        G_CHECKSUM_SHA256, fl_value_get_uint8_list(icon_bytes),
+        fl_value_get_length(icon_bytes));
+    return std::string("bytes:") + digest;
+  }
+  return std::string("path:") +
+         fl_value_get_string(fl_value_lookup_string(args, "iconPath"));
+}
+
+static void icon_cache_insert(const std::string& key, GdkPixbuf* pixbuf) {
+  auto it = icon_cache.find(key);
+  if (it == icon_cache.end()) {
+    g_object_ref(pixbuf);
+    it = icon_cache.emplace(key, IconCacheEntry{pixbuf, 0}).first;
+  }
+  it->second.last_used = ++icon_cache_use_count;
+
+  while (icon_cache.size() > kMaxIconCacheEntries) {
+    auto oldest = std::min_element(
+        icon_cache.begin(), icon_cache.end(), [](const auto& a, const auto& b) {
+          return a.second.last_used < b.second.last_used;
+        });
+    g_object_unref(oldest->second.pixbuf);
+    icon_cache.erase(oldest);
+  }
+}
+
+// Runs on a worker thread, so set_icon never reads or decodes an image on
+// the GTK main thread.
+static void decode_icon(GTask* task,
+                        gpointer source_object,
+                        gpointer task_data,
+                        GCancellable* cancellable) {
+  IconDecodeData* decode_data = static_cast<IconDecodeData*>(task_data);
+  GError* error = nullptr;
+  GdkPixbuf* pixbuf = nullptr;
+  if (decode_data->bytes == nullptr) {
+    pixbuf = gdk_pixbuf_new_from_file(decode_data->path.c_str(), &error);
+  } else {
+    g_autoptr(GdkPixbufLoader) loader = gdk_pixbuf_loader_new();
+    gsize length = 0;
+    const guchar* data = static_cast<const guchar*>(
+        g_bytes_get_data(decode_data->bytes, &length));
+    if (gdk_pixbuf_loader_write(loader, data, length, &error) &&
+        gdk_pixbuf_loader_close(loader, &error)) {
+      pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+      if (pixbuf != nullptr)
+        g_object_ref(pixbuf);
+    } else {
+      gdk_pixbuf_loader_close(loader, nullptr);
+    }
+  }
+
+  if (pixbuf != nullptr) {
+    g_task_return_pointer(task, pixbuf, g_object_unref);
+  } else if (error != nullptr) {
+    g_task_return_error(task, error);
+  } else {
+    g_task_return_new_error(task, GDK_PIXBUF_ERROR,
+                            GDK_PIXBUF_ERROR_UNKNOWN_TYPE,
+                            "Unrecognized icon image");
+  }
+}
+
+static void decode_icon_cb(GObject* object,
+                           GAsyncResult* result,
+                           gpointer user_data) {
+  WindowManagerPlusPlugin* self = WINDOW_MANAGER_PLUS_PLUGIN(object);
+  IconDecodeData* decode_data =
+      static_cast<IconDecodeData*>(g_task_get_task_data(G_TASK(result)));
+
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GdkPixbuf) pixbuf = static_cast<GdkPixbuf*>(
+      g_task_propagate_pointer(G_TASK(result), &error));
+  if (pixbuf != nullptr)
+    icon_cache_insert(decode_data->key, pixbuf);
+  else
+    g_warning("Failed to load icon: %s", error->message);
+
+  // Unless a later setIcon has taken over.
+  if (g_strcmp0(self->pending_icon_key, decode_data->key.c_str()) != 0)
+    return;
+  g_clear_pointer(&self->pending_icon_key, g_free);
+  GtkWindow* window = get_window(self);
+  if (pixbuf != nullptr && window != nullptr)
+    gtk_window_set_icon(window, pixbuf);
+}
+
+static FlMethodResponse* set_icon(WindowManagerPlusPlugin* self,
+                                  FlValue* args) {
+  std::string key = icon_cache_key(args);
+  g_clear_pointer(&self->pending_icon_key, g_free);
+
+  auto it = icon_cache.find(key);
+  if (it != icon_cache.end()) {
+    it->second.last_used = ++icon_cache_use_count;
+    gtk_window_set_icon(get_window(self), it->second.pixbuf);
+  } else {
+    IconDecodeData* decode_data = new IconDecodeData{key, "", nullptr};
+    FlValue* icon_bytes = fl_value_lookup_string(args, "iconBytes");
+    if (icon_bytes != nullptr &&
+        fl_value_get_type(icon_bytes) == FL_VALUE_TYPE_UINT8_LIST) {
+      decode_data->bytes = g_bytes_new(fl_value_get_uint8_list(icon_bytes),
+                                       fl_value_get_length(icon_bytes));
+    } else {
+      decode_data->path =
+          fl_value_get_string(fl_value_lookup_string(args, "iconPath"));
+    }
+    self->pending_icon_key = g_strdup(key.c_str());
+
+    g_autoptr(GTask) task = g_task_new(self, nullptr, decode_icon_cb, nullptr);
+    g_task_set_task_data(task, decode_data, icon_decode_data_free);
+    g_task_run_in_thread(task, decode_icon);
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* get_opacity(WindowManagerPlusPlugin* self) {
+  gdouble opacity = gtk_widget_get_opacity(GTK_WIDGET(get_window(self)));
+  g_autoptr(FlValue) result = fl_value_new_float(opacity);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_opacity(WindowManagerPlusPlugin* self,
+                                     FlValue* args) {
+  gdouble opacity = fl_value_get_float(fl_value_lookup_string(args, "opacity"));
+  gtk_widget_set_opacity(GTK_WIDGET(get_window(self)), opacity);
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* pop_up_window_menu(WindowManagerPlusPlugin* self) {
+  GdkWindow* window = get_gdk_window(self);
+  GdkDisplay* display = gdk_display_get_default();
+  GdkSeat* seat = gdk_display_get_default_seat(display);
+  GdkDevice* pointer = gdk_seat_get_pointer(seat);
+
+  int x, y;
+  gdk_device_get_position(pointer, NULL, &x, &y);
+
+  int origin_x, origin_y;
+  gdk_window_get_origin(window, &origin_x, &origin_y);
+
+  GdkEvent* event = gdk_event_new(GDK_BUTTON_PRESS);
+  event->button.window = window;
+  event->button.device = pointer;
+  event->button.x_root = x;
+  event->button.y_root = y;
+  event->button.x = x - origin_x;
+  event->button.y = y - origin_y;
+  gdk_window_show_window_menu(window, event);
+
+  g_autoptr(FlValue) result = fl_value_new_float(1);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* start_dragging(WindowManagerPlusPlugin* self) {
+  auto window = get_window(self);
+  auto screen = gtk_window_get_screen(window);
+  auto display = gdk_screen_get_display(screen);
+  auto seat = gdk_display_get_default_seat(display);
+  auto device = gdk_seat_get_pointer(seat);
+
+  gint root_x, root_y;
+  gdk_device_get_position(device, nullptr, &root_x, &root_y);
+  guint32 timestamp = (guint32)g_get_monotonic_time();
+
+  gtk_window_begin_move_drag(window, 1, root_x, root_y, timestamp);
+  self->_is_dragging = true;
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static void gtk_container_children_callback(GtkWidget* widget,
+                                            gpointer client_data) {
+  GList** children;
+  children = (GList**)client_data;
+  *children = g_list_prepend(*children, widget);
+}
+
+static void find_event_box(WindowManagerPlusPlugin* plugin,
+                           GtkWidget* widget) {
+  GList* children = NULL;
+  GtkWidget* current_child;
+  gtk_container_forall(GTK_CONTAINER(widget), gtk_container_children_callback,
+                       &children);
+  while (children) {
+    current_child = (GtkWidget*)children->data;
+    if (GTK_IS_EVENT_BOX(current_child)) {
+      plugin->_event_box = current_child;
+    }
+    children = children->next;
+  }
+}
+
+static FlMethodResponse* start_resizing(WindowManagerPlusPlugin* self,
+                                        FlValue* args) {
+  const gchar* resize_edge =
+      fl_value_get_string(fl_value_lookup_string(args, "resizeEdge"));
+
+  auto window = get_window(self);
+  auto screen = gtk_window_get_screen(window);
+  auto display = gdk_screen_get_display(screen);
+  auto seat = gdk_display_get_default_seat(display);
+  auto device = gdk_seat_get_pointer(seat);
+
+  gint root_x, root_y;
+  gdk_device_get_position(device, nullptr, &root_x, &root_y);
+  guint32 timestamp = (guint32)g_get_monotonic_time();
+
+  GdkWindowEdge gdk_window_edge = GDK_WINDOW_EDGE_NORTH_WEST;
+
+  if (g_strcmp0(resize_edge, "topLeft") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_NORTH_WEST;
+  } else if (g_strcmp0(resize_edge, "top") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_NORTH;
+  } else if (g_strcmp0(resize_edge, "topRight") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_NORTH_EAST;
+  } else if (g_strcmp0(resize_edge, "left") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_WEST;
+  } else if (g_strcmp0(resize_edge, "right") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_EAST;
+  } else if (g_strcmp0(resize_edge, "bottomLeft") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_SOUTH_WEST;
+  } else if (g_strcmp0(resize_edge, "bottom") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_SOUTH;
+  } else if (g_strcmp0(resize_edge, "bottomRight") == 0) {
+    gdk_window_edge = GDK_WINDOW_EDGE_SOUTH_EAST;
+  }
+
+  gtk_window_begin_resize_drag(window, gdk_window_edge,
+                               self->_event_button.button, root_x, root_y,
+                               timestamp);
+  self->_is_resizing = true;
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static const gchar* gdk_grab_status_code(GdkGrabStatus status) {
+  switch (status) {
+    case GDK_GRAB_SUCCESS:
+      return "GDK_GRAB_SUCCESS";
+    case GDK_GRAB_ALREADY_GRABBED:
+      return "GDK_GRAB_ALREADY_GRABBED";
+    case GDK_GRAB_INVALID_TIME:
+      return "GDK_GRAB_INVALID_TIME";
+    case GDK_GRAB_NOT_VIEWABLE:
+      return "GDK_GRAB_NOT_VIEWABLE";
+    case GDK_GRAB_FROZEN:
+      return "GDK_GRAB_FROZEN";
+    case GDK_GRAB_FAILED:
+      return "GDK_GRAB_FAILED";
+    default:
+      return "GDK_GRAB_???";
+  }
+}
+
+static const gchar* gdk_grab_status_message(GdkGrabStatus status) {
+  switch (status) {
+    case GDK_GRAB_SUCCESS:
+      return "The resource was successfully grabbed.";
+    case GDK_GRAB_ALREADY_GRABBED:
+      return "The resource is actively grabbed by another client.";
+    case GDK_GRAB_INVALID_TIME:
+      return "The resource was grabbed more recently than the specified time.";
+    case GDK_GRAB_NOT_VIEWABLE:
+      return "The grab window or the confine_to window are not viewable.";
+    case GDK_GRAB_FROZEN:
+      return "The resource is frozen by an active grab of another client.";
+    case GDK_GRAB_FAILED:
+      return "The grab failed for some other reason.";
+    default:
+      return "The grab status is unknown.";
+  }
+}
+
+static GdkGrabStatus gdk_grab_keyboard(WindowManagerPlusPlugin* self) {
+  g_return_val_if_fail(self->grab_pointer == nullptr, GDK_GRAB_FAILED);
+
+  auto window = get_window(self);
+  auto screen = gtk_window_get_screen(window);
+  auto display = gdk_screen_get_display(screen);
+  auto seat = gdk_display_get_default_seat(display);
+  auto gdk_window = get_gdk_window(self);
+
+  GdkGrabStatus status = gdk_seat_grab(
+      seat, gdk_window, GDK_SEAT_CAPABILITY_KEYBOARD, false /* owner_events */,
+      nullptr /* cursor */, nullptr /* event */, nullptr /*prepare_func */,
+      nullptr /* prepare_func_data */);
+
+  self->grab_pointer = gdk_seat_get_keyboard(seat);
+  if (!self->grab_pointer) {
+    self->grab_pointer = gdk_seat_get_pointer(seat);
+  }
+
+  return status;
+}
+
+static FlMethodResponse* grab_keyboard(WindowManagerPlusPlugin* self) {
+  GdkGrabStatus status = gdk_grab_keyboard(self);
+
+  if (status != GDK_GRAB_SUCCESS) {
+    return FL_METHOD_RESPONSE(
+        fl_method_error_response_new(gdk_grab_status_code(status),
+                                     gdk_grab_status_message(status), nullptr));
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* ungrab_keyboard(WindowManagerPlusPlugin* self) {
+  if (self->grab_pointer != nullptr) {
+    gdk_seat_ungrab(gdk_device_get_seat(self->grab_pointer));
+    self->grab_pointer = nullptr;
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* set_brightness(WindowManagerPlusPlugin* self,
+                                        FlValue* args) {
+  const gchar* brightness =
+      fl_value_get_string(fl_value_lookup_string(args, "brightness"));
+
+  gboolean dark = g_strcmp0(brightness, "dark") == 0;
+
+  GtkSettings* settings = gtk_settings_get_default();
+  g_object_set(settings, "gtk-application-prefer-dark-theme", dark, nullptr);
+
+  if (!dark) {
+    // `gtk-application-prefer-dark-theme=false` is not enough to switch to the
+    // light mode if the current theme is a dark variant such as "Yaru-dark" or
+    // "Adwaita-dark". try switching to the light variant without a "-dark"
+    // suffix.
+    g_autofree gchar* theme_name = nullptr;
+    g_object_get(settings, "gtk-theme-name", &theme_name, nullptr);
+    if (g_str_has_suffix(theme_name, "-dark")) {
+      g_autofree gchar* light_theme_name =
+          g_strndup(theme_name, strlen(theme_name) - 5);
+      g_object_set(settings, "gtk-theme-name", light_theme_name, nullptr);
+    }
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+void _emit_global_event(WindowManagerPlusPlugin* plugin,
+                        const char* event_name);
+static void method_call_cb(FlMethodChannel* channel,
+                           FlMethodCall* method_call,
+                           gpointer user_data);
+
+// The handler doesn't hold a reference to |self|: the plugin owns its
+// channels, so one would keep both alive. The window owns the plugin instead
+// and on_window_destroy detaches the handlers before releasing it.
+static FlMethodChannel* new_method_channel(WindowManagerPlusPlugin* self,
+                                           const gchar* name,
+                                           FlMethodChannelMethodCallHandler
+                                               handler) {
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  FlMethodChannel* channel = fl_method_channel_new(
+      fl_plugin_registrar_get_messenger(self->registrar), name,
+      FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(channel, handler, self, nullptr);
+  return channel;
+}
+
+// Moves the plugin onto the channel of its window id, which the Dart side
+// uses from now on.
+static FlMethodResponse* ensure_initialized(WindowManagerPlusPlugin* self,
+                                           FlValue* args) {
+  gint64 window_id =
+      fl_value_get_int(fl_value_lookup_string(args, "windowId"));
+  if (window_id < 0) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "0", "Cannot ensureInitialized! windowId >= 0 is required", nullptr));
+  }
+  if (window_id != 0 &&
+      created_windows.find(window_id) == created_windows.end()) {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "0", "Cannot ensureInitialized! windowId was not created", nullptr));
+  }
+
+  // A plugin left over for the id, e.g. from a restarted engine, no longer
+  // answers on the window's channel.
+  WindowManagerPlusPlugin* existing = find_window_plugin(window_id);
+  if (existing != nullptr && existing != self)
+    g_clear_object(&existing->channel);
+
+  self->window_id = window_id;
+  g_autofree gchar* channel_name =
+      g_strdup_printf("window_manager_plus_%" G_GINT64_FORMAT, window_id);
+  g_clear_object(&self->channel);
+  self->channel = new_method_channel(self, channel_name, method_call_cb);
+  window_plugins[window_id] = self;
+
+  _emit_global_event(self, "initialized");
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* first_frame_rasterized(WindowManagerPlusPlugin* self) {
+  auto it = pending_first_frames.find(self->window_id);
+  if (it != pending_first_frames.end()) {
+    first_frame_ms += static_cast<gdouble>(g_get_monotonic_time() -
+                                           it->second) /
+                      G_TIME_SPAN_MILLISECOND;
+    first_frame_count++;
+    pending_first_frames.erase(it);
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static void invoke_method_to_window_cb(GObject* object,
+                                       GAsyncResult* result,
+                                       gpointer user_data) {
+  g_autoptr(FlMethodCall) method_call = FL_METHOD_CALL(user_data);
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(FlMethodResponse) response = fl_method_channel_invoke_method_finish(
+      FL_METHOD_CHANNEL(object), result, &error);
+  if (response == nullptr) {
+    g_autoptr(FlMethodResponse) error_response = FL_METHOD_RESPONSE(
+        fl_method_error_response_new("0", error->message, nullptr));
+    fl_method_call_respond(method_call, error_response, nullptr);
+  } else if (FL_IS_METHOD_NOT_IMPLEMENTED_RESPONSE(response)) {
+    g_autoptr(FlMethodResponse) error_response = FL_METHOD_RESPONSE(
+        fl_method_error_response_new("0", "Method not implemented", nullptr));
+    fl_method_call_respond(method_call, error_response, nullptr);
+  } else {
+    fl_method_call_respond(method_call, response, nullptr);
+  }
+}
+
+// Forwards "args" to the window with id "targetWindowId" and responds with
+// what its Dart side returns.
+static void invoke_method_to_window(WindowManagerPlusPlugin* self,
+                                    FlMethodCall* method_call) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  WindowManagerPlusPlugin* target = find_window_plugin(
+      fl_value_get_int(fl_value_lookup_string(args, "targetWindowId")));
+  if (target == nullptr || target->channel == nullptr) {
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_error_response_new(
+            "0", "Cannot invokeMethodToWindow! targetWindowId not found",
+            nullptr));
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  fl_method_channel_invoke_method(
+      target->channel, "onEvent", fl_value_lookup_string(args, "args"),
+      nullptr, invoke_method_to_window_cb, g_object_ref(method_call));
+}
+
+static FlMethodResponse* set_event_fast_path(WindowManagerPlusPlugin* self,
+                                             FlValue* args) {
+  bool enabled = fl_value_get_bool(fl_value_lookup_string(args, "enabled"));
+  if (self->window_id < 0) {
+    // The ring is found by window id, which is only known after
+    // ensureInitialized.
+    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "0", "Cannot setEventFastPath! ensureInitialized must be called first",
+        nullptr));
+  }
+
+  std::lock_guard<std::mutex> lock(event_ring_mutex);
+  if (enabled && self->event_ring_ == nullptr) {
+    auto ring = std::make_shared<WindowEventRing>();
+    self->event_ring_ = ring.get();
+    event_rings[self->window_id] = std::move(ring);
+  } else if (!enabled && self->event_ring_ != nullptr) {
+    event_rings.erase(self->window_id);
+    self->event_ring_ = nullptr;
+  }
+
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Records |event_id| in the ring of the event fast path. Returns false if the
+// fast path is disabled or the ring is full, in which case the event must go
+// over the channel.
+static bool push_fast_path_event(WindowManagerPlusPlugin* self,
+                                 int32_t event_id) {
+  if (self->event_ring_ == nullptr)
+    return false;
+
+  GtkWindow* window = get_window(self);
+  gint x, y, width, height;
+  gtk_window_get_position(window, &x, &y);
+  gtk_window_get_size(window, &width, &height);
+
+  WindowManagerPlusEvent event = {};
+  event.event_id = event_id;
+  event.window_id = self->window_id;
+  event.timestamp_us = g_get_monotonic_time();
+  event.x = x;
+  event.y = y;
+  event.width = width;
+  event.height = height;
+  return self->event_ring_->Push(event);
+}
+
+static FlMethodResponse* get_coalesced_event_count(
+    WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_int(self->coalesced_event_count);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* wait_until_ready_to_show(
+    WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_bool(true);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+typedef FlMethodResponse* (*MethodHandler)(WindowManagerPlusPlugin* self,
+                                           FlValue* args);
+
+typedef struct {
+  const gchar* name;
+  MethodHandler handler;
+} MethodHandlerEntry;
+
+static const MethodHandlerEntry method_handlers[] = {
+    {"firstFrameRasterized",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return first_frame_rasterized(self);
+     }},
+    {"waitUntilReadyToShow",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return wait_until_ready_to_show(self);
+     }},
+    {"setAsFrameless", set_as_frameless},
+    {"destroy",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return destroy(self);
+     }},
+    {"close",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return close(self); }},
+    {"setPreventClose", set_prevent_close},
+    {"isPreventClose",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_prevent_close(self);
+     }},
+    {"focus",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return focus(self); }},
+    {"blur",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return blur(self); }},
+    {"isFocused",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_focused(self);
+     }},
+    {"show",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return show(self); }},
+    {"hide",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return hide(self); }},
+    {"isVisible",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_visible(self);
+     }},
+    {"isMaximized",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_maximized(self);
+     }},
+    {"maximize",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return maximize(self);
+     }},
+    {"unmaximize",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return unmaximize(self);
+     }},
+    {"isMinimized",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_minimized(self);
+     }},
+    {"minimize",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return minimize(self);
+     }},
+    {"restore",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return restore(self);
+     }},
+    {"isDockable",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_dockable(self);
+     }},
+    {"isDocked",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_docked(self);
+     }},
+    {"dock",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return dock(self); }},
+    {"undock",
+     [](WindowManagerPlusPlugin* self, FlValue* args) { return undock(self); }},
+    {"isFullScreen",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_full_screen(self);
+     }},
+    {"setFullScreen", set_full_screen},
+    {"setAspectRatio", set_aspect_ratio},
+    {"setBackgroundColor", set_background_color},
+    {"getBounds",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_bounds(self);
+     }},
+    {"getWindowState",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_window_state(self);
+     }},
+    {"setBounds", set_bounds},
+    {"setMinimumSize", set_minimum_size},
+    {"setMaximumSize", set_maximum_size},
+    {"setWindowConstraints", set_window_constraints},
+    {"isResizable",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_resizable(self);
+     }},
+    {"setResizable", set_resizable},
+    {"isMinimizable",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_minimizable(self);
+     }},
+    {"setMinimizable", set_minimizable},
+    {"isMaximizable",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_maximizable(self);
+     }},
+    {"setMaximizable", set_maximizable},
+    {"isClosable",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_closable(self);
+     }},
+    {"setClosable", set_closable},
+    {"isAlwaysOnTop",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_always_on_top(self);
+     }},
+    {"setAlwaysOnTop", set_always_on_top},
+    {"isAlwaysOnBottom",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_always_on_bottom(self);
+     }},
+    {"setAlwaysOnBottom", set_always_on_bottom},
+    {"getTitle",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_title(self);
+     }},
+    {"setTitle", set_title},
+    {"setTitleBarStyle", set_title_bar_style},
+    {"getTitleBarHeight", get_title_bar_height},
+    {"isSkipTaskbar",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return is_skip_taskbar(self);
+     }},
+    {"setSkipTaskbar", set_skip_taskbar},
+    {"setIcon", set_icon},
+    {"getOpacity",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_opacity(self);
+     }},
+    {"setOpacity", set_opacity},
+    {"popUpWindowMenu",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return pop_up_window_menu(self);
+     }},
+    {"startDragging",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return start_dragging(self);
+     }},
+    {"startResizing", start_resizing},
+    {"grabKeyboard",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return grab_keyboard(self);
+     }},
+    {"ungrabKeyboard",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return ungrab_keyboard(self);
+     }},
+    {"setBrightness", set_brightness},
+    {"setEventFastPath", set_event_fast_path},
+    {"getCoalescedEventCount",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_coalesced_event_count(self);
+     }},
+};
+
+// Forgets a window made by createWindow once it is gone, so its id is no
+// longer listed by getAllWindowManagerIds.
+static void on_created_window_destroy(GtkWidget* widget, gpointer data) {
+  for (auto it = created_windows.begin(); it != created_windows.end(); ++it) {
+    if (GTK_WIDGET(it->second) != widget)
+      continue;
+
+    WindowManagerPlusPlugin* plugin = find_window_plugin(it->first);
+    if (plugin != nullptr) {
+      g_clear_object(&plugin->channel);
+      window_plugins.erase(it->first);
+    }
+    {
+      std::lock_guard<std::mutex> lock(event_ring_mutex);
+      event_rings.erase(it->first);
+      if (plugin != nullptr)
+        plugin->event_ring_ = nullptr;
+    }
+    pending_first_frames.erase(it->first);
+    created_windows.erase(it);
+    return;
+  }
+}
+
+// Creates a window through the callback of the runner, see
+// window_manager_plus_plugin_set_window_created_callback. The new engine gets
+// the window id as its first entrypoint argument, followed by "args".
+static FlMethodResponse* create_window(WindowManagerPlusPlugin* self,
+                                      FlValue* args) {
+  if (window_created_callback == nullptr) {
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  gint64 window_id = next_window_id++;
+  g_autoptr(GPtrArray) arguments = g_ptr_array_new_with_free_func(g_free);
+  g_ptr_array_add(arguments,
+                  g_strdup_printf("%" G_GINT64_FORMAT, window_id));
+  FlValue* extra_args = fl_value_lookup_string(args, "args");
+  if (extra_args != nullptr &&
+      fl_value_get_type(extra_args) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(extra_args); i++) {
+      g_ptr_array_add(arguments, g_strdup(fl_value_get_string(
+                                     fl_value_get_list_value(extra_args, i))));
+    }
+  }
+  g_ptr_array_add(arguments, nullptr);
+
+  gint64 created_at = g_get_monotonic_time();
+  GtkWindow* window =
+      window_created_callback(reinterpret_cast<gchar**>(arguments->pdata));
+  if (window == nullptr) {
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  created_windows[window_id] = window;
+  pending_first_frames[window_id] = created_at;
+  g_signal_connect(window, "destroy", G_CALLBACK(on_created_window_destroy),
+                   nullptr);
+
+  g_autoptr(FlValue) result = fl_value_new_int(window_id);
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+static FlMethodResponse* get_all_window_manager_ids(
+    WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_list();
+  for (const auto& [window_id, plugin] : window_plugins)
+    fl_value_append_take(result, fl_value_new_int(window_id));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// There is no window pool on Linux, every window counts as unpooled.
+static FlMethodResponse* get_window_pool_metrics(
+    WindowManagerPlusPlugin* self) {
+  g_autoptr(FlValue) result = fl_value_new_map();
+  fl_value_set_string_take(result, "size", fl_value_new_int(0));
+  fl_value_set_string_take(result, "ready", fl_value_new_int(0));
+  fl_value_set_string_take(result, "warming", fl_value_new_int(0));
+  fl_value_set_string_take(result, "hits", fl_value_new_int(0));
+  fl_value_set_string_take(result, "misses", fl_value_new_int(0));
+  fl_value_set_string_take(result, "pooledTimeToFirstFrame",
+                           fl_value_new_float(0));
+  fl_value_set_string_take(
+      result, "unpooledTimeToFirstFrame",
+      fl_value_new_float(first_frame_count > 0
+                             ? first_frame_ms / first_frame_count
+                             : 0));
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// The methods of the "window_manager_plus_static" channel, which are not
+// bound to a window.
+static const MethodHandlerEntry static_method_handlers[] = {
+    {"applyLayout", apply_layout},
+    {"createWindow", create_window},
+    {"getAllWindowManagerIds",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_all_window_manager_ids(self);
+     }},
+    {"getWindowPoolMetrics",
+     [](WindowManagerPlusPlugin* self, FlValue* args) {
+       return get_window_pool_metrics(self);
+     }},
+};
+
+// Map method names to their entry in method_handlers and
+// static_method_handlers, built once when the plugin class is initialized so
+// a method call is a single hash lookup.
+static GHashTable* method_handler_table = nullptr;
+static GHashTable* static_method_handler_table = nullptr;
+
+template <size_t N>
+static GHashTable* new_method_handler_table(
+    const MethodHandlerEntry (&handlers)[N]) {
+  GHashTable* table = g_hash_table_new(g_str_hash, g_str_equal);
+  for (const MethodHandlerEntry& entry : handlers) {
+    g_hash_table_insert(table, const_cast<gchar*>(entry.name),
+                        const_cast<MethodHandlerEntry*>(&entry));
+  }
+  return table;
+}
+
+static void init_method_handler_table() {
+  method_handler_table = new_method_handler_table(method_handlers);
+  static_method_handler_table =
+      new_method_handler_table(static_method_handlers);
+}
+
+static void respond_with_handler(GHashTable* table,
+                                 WindowManagerPlusPlugin* self,
+                                 FlMethodCall* method_call) {
+  g_autoptr(FlMethodResponse) response = nullptr;
+
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+
+  const MethodHandlerEntry* entry = static_cast<const MethodHandlerEntry*>(
+      g_hash_table_lookup(table, method));
+  if (entry != nullptr) {
+    response = entry->handler(self, args);
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+
+  fl_method_call_respond(method_call, response, nullptr);
+}
+
+// Called when a method call is received from Flutter. A "windowId" argument
+// addresses another window, see WindowManagerPlus.fromWindowId.
+static void window_manager_plus_plugin_handle_method_call(
+    WindowManagerPlusPlugin* self,
+    FlMethodCall* method_call) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+
+  // Both act on the plugin that received the call, and invokeMethodToWindow
+  // only responds once the target window has.
+  if (g_strcmp0(method, "ensureInitialized") == 0) {
+    g_autoptr(FlMethodResponse) response = ensure_initialized(self, args);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+  if (g_strcmp0(method, "invokeMethodToWindow") == 0) {
+    invoke_method_to_window(self, method_call);
+    return;
+  }
+
+  WindowManagerPlusPlugin* target = self;
+  FlValue* window_id = args != nullptr &&
+                               fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                           ? fl_value_lookup_string(args, "windowId")
+                           : nullptr;
+  if (window_id != nullptr &&
+      fl_value_get_type(window_id) == FL_VALUE_TYPE_INT) {
+    // A stale id must not fall back to the window that made the call.
+    target = find_window_plugin(fl_value_get_int(window_id));
+    if (target == nullptr) {
+      g_autofree gchar* message =
+          g_strdup_printf("No window with windowId %" G_GINT64_FORMAT,
+                          fl_value_get_int(window_id));
+      fl_method_call_respond_error(method_call, "INVALID_WINDOW_ID", message,
+                                   nullptr, nullptr);
+      return;
+    }
+  }
+
+  respond_with_handler(method_handler_table, target, method_call);
+}
+
+static void window_manager_plus_plugin_dispose(GObject* object) {
+  WindowManagerPlusPlugin* self = WINDOW_MANAGER_PLUS_PLUGIN(object);
+  g_clear_object(&self->css_provider);
+  g_free(self->title_bar_style_);
+  stop_bounds_animation(self);
+  g_clear_pointer(&self->bounds_animation_curve, g_free);
+  stop_geometry_tracking(self);
+  g_clear_pointer(&self->pending_icon_key, g_free);
+  if (find_window_plugin(self->window_id) == self)
+    window_plugins.erase(self->window_id);
+  if (self->event_ring_ != nullptr) {
+    std::lock_guard<std::mutex> lock(event_ring_mutex);
+    event_rings.erase(self->window_id);
+    self->event_ring_ = nullptr;
+  }
+  g_clear_object(&self->channel);
+  g_clear_object(&self->static_channel);
+  G_OBJECT_CLASS(window_manager_plus_plugin_parent_class)->dispose(object);
+}
+
+static void window_manager_plus_plugin_class_init(
+    WindowManagerPlusPluginClass* klass) {
+  G_OBJECT_CLASS(klass)->dispose = window_manager_plus_plugin_dispose;
+  init_method_handler_table();
+}
+
+static void window_manager_plus_plugin_init(WindowManagerPlusPlugin* self) {
+  self->window_id = -1;
+  self->background_color = -1;
+}
+
+static void method_call_cb(FlMethodChannel* channel,
+                           FlMethodCall* method_call,
+                           gpointer user_data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(user_data);
+  window_manager_plus_plugin_handle_method_call(plugin, method_call);
+}
+
+static void static_method_call_cb(FlMethodChannel* channel,
+                                  FlMethodCall* method_call,
+                                  gpointer user_data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(user_data);
+  respond_with_handler(static_method_handler_table, plugin, method_call);
+}
+
+void _emit_event(WindowManagerPlusPlugin* plugin, const char* event_name) {
+  if (plugin->channel != nullptr) {
+    g_autoptr(FlValue) result_data = fl_value_new_map();
+    fl_value_set_string_take(result_data, "eventName",
+                             fl_value_new_string(event_name));
+    fl_method_channel_invoke_method(plugin->channel, "onEvent", result_data,
+                                    nullptr, nullptr, nullptr);
+  }
+  _emit_global_event(plugin, event_name);
+}
+
+// Tells every initialized window, including this one, about |event_name| of
+// this window.
+void _emit_global_event(WindowManagerPlusPlugin* plugin,
+                        const char* event_name) {
+  if (plugin->window_id < 0)
+    return;
+
+  g_autoptr(FlValue) result_data = fl_value_new_map();
+  fl_value_set_string_take(result_data, "eventName",
+                           fl_value_new_string(event_name));
+  fl_value_set_string_take(result_data, "windowId",
+                           fl_value_new_int(plugin->window_id));
+  for (const auto& [window_id, window_plugin] : window_plugins) {
+    if (window_plugin->channel != nullptr) {
+      fl_method_channel_invoke_method(window_plugin->channel, "onEvent",
+                                      result_data, nullptr, nullptr, nullptr);
+    }
+  }
+}
+
+gboolean on_window_close(GtkWidget* widget, GdkEvent* event, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  _emit_event(plugin, "close");
+  return plugin->_is_prevent_close;
+}
+
+gboolean on_window_focus(GtkWidget* widget, GdkEvent* event, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  _emit_event(plugin, "focus");
+  return false;
+}
+
+gboolean on_window_blur(GtkWidget* widget, GdkEvent* event, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  _emit_event(plugin, "blur");
+  return false;
+}
+
+gboolean on_window_show(GtkWidget* widget, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  _emit_event(plugin, "show");
+  return false;
+}
+
+gboolean on_window_hide(GtkWidget* widget, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  _emit_event(plugin, "hide");
+  return false;
+}
+
+// How long the window must stay put after a move or resize before "moved"
+// or "resized" is emitted. GTK has no end of a move/resize gesture like
+// WM_EXITSIZEMOVE on Windows.
+static const guint kGeometryQuiescenceMs = 250;
+
+// With the event fast path only the other windows hear about moves and
+// resizes over their channels.
+static void emit_move_or_resize_event(WindowManagerPlusPlugin* self,
+                                      bool is_resize) {
+  const char* event_name = is_resize ? "resize" : "move";
+  int32_t event_id = is_resize ? WINDOW_MANAGER_PLUS_EVENT_RESIZE
+                               : WINDOW_MANAGER_PLUS_EVENT_MOVE;
+  if (push_fast_path_event(self, event_id))
+    _emit_global_event(self, event_name);
+  else
+    _emit_event(self, event_name);
+}
+
+static void flush_coalesced_events(WindowManagerPlusPlugin* self) {
+  if (self->is_move_event_pending) {
+    self->is_move_event_pending = false;
+    emit_move_or_resize_event(self, false);
+  }
+  if (self->is_resize_event_pending) {
+    self->is_resize_event_pending = false;
+    emit_move_or_resize_event(self, true);
+  }
+}
+
+static gboolean event_coalescing_tick(GtkWidget* widget,
+                                      GdkFrameClock* frame_clock,
+                                      gpointer data) {
+  WindowManagerPlusPlugin* self = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  if (!self->is_move_event_pending && !self->is_resize_event_pending) {
+    // Nothing arrived during the last frame, the burst is over.
+    self->event_coalescing_tick_id = 0;
+    return G_SOURCE_REMOVE;
+  }
+  flush_coalesced_events(self);
+  return G_SOURCE_CONTINUE;
+}
+
+// Emits at most one "move" and one "resize" per frame.
+static void queue_coalesced_event(WindowManagerPlusPlugin* self,
+                                  bool is_resize) {
+  bool& pending =
+      is_resize ? self->is_resize_event_pending : self->is_move_event_pending;
+  if (pending) {
+    self->coalesced_event_count++;
+    return;
+  }
+  pending = true;
+
+  if (self->event_coalescing_tick_id == 0) {
+    // Emit the first event of a burst right away so listeners don't lag
+    // behind the drag, then let the frame clock deliver the rest.
+    flush_coalesced_events(self);
+    self->event_coalescing_tick_id = gtk_widget_add_tick_callback(
+        GTK_WIDGET(get_window(self)), event_coalescing_tick, self, nullptr);
+  }
+}
+
+static gboolean geometry_quiescence_timeout(gpointer data) {
+  WindowManagerPlusPlugin* self = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  self->geometry_quiescence_source_id = 0;
+  flush_coalesced_events(self);
+  if (self->is_resizing) {
+    self->is_resizing = false;
+    _emit_event(self, "resized");
+  }
+  if (self->is_moving) {
+    self->is_moving = false;
+    _emit_event(self, "moved");
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// Compares the window's geometry with the last one seen and queues "move"
+// and "resize" for what changed. Notifications that changed nothing are
+// dropped.
+//
+// Both signals read the geometry from the window rather than from the
+// configure event, whose size includes client-side decorations.
+static void update_window_geometry(WindowManagerPlusPlugin* self) {
+  GtkWindow* window = get_window(self);
+  GdkRectangle geometry;
+  gtk_window_get_position(window, &geometry.x, &geometry.y);
+  gtk_window_get_size(window, &geometry.width, &geometry.height);
+
+  const GdkRectangle& last = self->last_geometry;
+  bool moved = !self->has_last_geometry || geometry.x != last.x ||
+               geometry.y != last.y;
+  bool resized = !self->has_last_geometry || geometry.width != last.width ||
+                 geometry.height != last.height;
+  self->last_geometry = geometry;
+  self->has_last_geometry = true;
+  if (!moved && !resized) {
+    self->coalesced_event_count++;
+    return;
+  }
+
+  if (moved)
+    queue_coalesced_event(self, false);
+  if (resized)
+    queue_coalesced_event(self, true);
+
+  // A bounds animation emits "moved" and "resized" itself when it is over.
+  if (self->bounds_animation_tick_id != 0)
+    return;
+  // The notifications of its last frames can still arrive after that, up to
+  // the one with its final geometry. Anything later is a move of its own.
+  if (self->bounds_animation_end != 0) {
+    const GdkRectangle& to = self->bounds_animation_to;
+    bool settled = geometry.x == to.x && geometry.y == to.y &&
+                   geometry.width == to.width && geometry.height == to.height;
+    bool expired = g_get_monotonic_time() - self->bounds_animation_end >
+                   kGeometryQuiescenceMs * G_TIME_SPAN_MILLISECOND;
+    if (settled || expired)
+      self->bounds_animation_end = 0;
+    if (!expired)
+      return;
+  }
+  self->is_moving = self->is_moving || moved;
+  self->is_resizing = self->is_resizing || resized;
+  if (self->geometry_quiescence_source_id != 0)
+    g_source_remove(self->geometry_quiescence_source_id);
+  self->geometry_quiescence_source_id = g_timeout_add(
+      kGeometryQuiescenceMs, geometry_quiescence_timeout, self);
+}
+
+gboolean on_window_resize(GtkWidget* widget, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  update_window_geometry(plugin);
+  return false;
+}
+
+gboolean on_window_move(GtkWidget* widget, GdkEvent* event, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  update_window_geometry(plugin);
+  return false;
+}
+
+gboolean on_window_state_change(GtkWidget* widget,
+                                GdkEventWindowState* event,
+                                gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  if (event->changed_mask & GDK_WINDOW_STATE_MAXIMIZED) {
+    if (event->new_window_state & GDK_WINDOW_STATE_MAXIMIZED) {
+      _emit_event(plugin, "maximize");
+    } else {
+      _emit_event(plugin, "unmaximize");
+    }
+  }
+  if (event->changed_mask & GDK_WINDOW_STATE_ICONIFIED) {
+    if (event->new_window_state & GDK_WINDOW_STATE_ICONIFIED) {
+      _emit_event(plugin, "minimize");
+    } else {
+      _emit_event(plugin, "restore");
+    }
+  }
+  if (event->changed_mask & GDK_WINDOW_STATE_FULLSCREEN) {
+    if (event->new_window_state & GDK_WINDOW_STATE_FULLSCREEN) {
+      _emit_event(plugin, "enter-full-screen");
+    } else {
+      _emit_event(plugin, "leave-full-screen");
+    }
+  }
+  return false;
+}
+
+void on_window_realize(GtkWidget* widget, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  plugin->gdk_window = gtk_widget_get_window(widget);
+}
+
+void on_window_unrealize(GtkWidget* widget, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  plugin->gdk_window = nullptr;
+}
+
+void on_window_destroy(GtkWidget* widget, gpointer data) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(data);
+  stop_geometry_tracking(plugin);
+  plugin->window = nullptr;
+  plugin->gdk_window = nullptr;
+
+  // Calls still arriving on the channels must not reach the plugin once the
+  // window's reference to it is gone.
+  if (plugin->channel != nullptr) {
+    fl_method_channel_set_method_call_handler(plugin->channel, nullptr,
+                                              nullptr, nullptr);
+  }
+  if (plugin->static_channel != nullptr) {
+    fl_method_channel_set_method_call_handler(plugin->static_channel,
+                                              nullptr, nullptr, nullptr);
+  }
+  g_object_unref(plugin);
+}
+
+void emit_button_release(WindowManagerPlusPlugin* self) {
+  auto newEvent = (GdkEventButton*)gdk_event_new(GDK_BUTTON_RELEASE);
+  newEvent->x = self->_event_button.x;
+  newEvent->y = self->_event_button.y;
+  newEvent->button = self->_event_button.button;
+  newEvent->type = GDK_BUTTON_RELEASE;
+  newEvent->time = g_get_monotonic_time();
+  gboolean result;
+  g_signal_emit_by_name(self->_event_box, "button-release-event", newEvent,
+                        &result);
+  gdk_event_free((GdkEvent*)newEvent);
+}
+
+gboolean on_event_after(GtkWidget* text_view,
+                        GdkEvent* event,
+                        WindowManagerPlusPlugin* self) {
+  if (event->type == GDK_ENTER_NOTIFY) {
+    if (nullptr == self->_event_box) {
+      return FALSE;
+    }
+    if (self->_is_dragging) {
+      self->_is_dragging = false;
+      emit_button_release(self);
+    }
+    if (self->_is_resizing) {
+      self->_is_resizing = false;
+      emit_button_release(self);
+    }
+  }
+  return FALSE;
+}
+
+// Keeps the last press in each window for startDragging and startResizing,
+// in the plugin of the window the pressed widget is in.
+gboolean on_mouse_press(GSignalInvocationHint* ihint,
+                        guint n_param_values,
+                        const GValue* param_values,
+                        gpointer data) {
+  GtkWidget* widget = GTK_WIDGET(g_value_get_object(param_values));
+  GdkEventButton* event_button =
+      (GdkEventButton*)(g_value_get_boxed(param_values + 1));
+
+  GtkWidget* toplevel = gtk_widget_get_toplevel(widget);
+  for (const auto& [window_id, plugin] : window_plugins) {
+    if (GTK_WIDGET(get_window(plugin)) != toplevel)
+      continue;
+    memset(&plugin->_event_button, 0, sizeof(plugin->_event_button));
+    memcpy(&plugin->_event_button, event_button,
+           sizeof(plugin->_event_button));
+    break;
+  }
+  return TRUE;
+}
+
+void window_manager_plus_plugin_register_with_registrar(
+    FlPluginRegistrar* registrar) {
+  WindowManagerPlusPlugin* plugin = WINDOW_MANAGER_PLUS_PLUGIN(
+      g_object_new(window_manager_plus_plugin_get_type(), nullptr));
+
+  plugin->registrar = FL_PLUGIN_REGISTRAR(g_object_ref(registrar));
+
+  plugin->window_geometry.min_width = -1;
+  plugin->window_geometry.min_height = -1;
+  plugin->window_geometry.max_width = G_MAXINT;
+  plugin->window_geometry.max_height = G_MAXINT;
+
+  GtkWindow* window = get_window(plugin);
+
+  // Disconnect all delete-event handlers first in flutter 3.10.1, which causes delete_event not working.
+  // Issues from flutter/engine: https://github.com/flutter/engine/pull/40033 
+  guint handler_id = g_signal_handler_find(window, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, fl_plugin_registrar_get_view(plugin->registrar));
+  if (handler_id > 0) {
+    g_signal_handler_disconnect(window, handler_id);
+  }
+
+  g_signal_connect(window, "delete_event",
+                   G_CALLBACK(on_window_close), plugin);
+  g_signal_connect(window, "focus-in-event",
+                   G_CALLBACK(on_window_focus), plugin);
+  g_signal_connect(window, "focus-out-event",
+                   G_CALLBACK(on_window_blur), plugin);
+  g_signal_connect(window, "show", G_CALLBACK(on_window_show),
+                   plugin);
+  g_signal_connect(window, "hide", G_CALLBACK(on_window_hide),
+                   plugin);
+  g_signal_connect(window, "check-resize",
+                   G_CALLBACK(on_window_resize), plugin);
+  g_signal_connect(window, "configure-event",
+                   G_CALLBACK(on_window_move), plugin);
+  g_signal_connect(window, "window-state-event",
+                   G_CALLBACK(on_window_state_change), plugin);
+  g_signal_connect(window, "event-after",
+                   G_CALLBACK(on_event_after), plugin);
+  g_signal_connect(window, "realize", G_CALLBACK(on_window_realize), plugin);
+  g_signal_connect(window, "unrealize", G_CALLBACK(on_window_unrealize),
+                   plugin);
+  g_signal_connect(window, "destroy", G_CALLBACK(on_window_destroy), plugin);
+  find_event_box(plugin, GTK_WIDGET(fl_plugin_registrar_get_view(registrar)));
+
+  if (mouse_press_hook_id == 0) {
+    mouse_press_hook_id = g_signal_add_emission_hook(
+        g_signal_lookup("button-press-event", GTK_TYPE_WIDGET), 0,
+        on_mouse_press, nullptr, nullptr);
+  }
+
+  // The Dart side asks for its window id on this temporary channel, see
+  // ensure_initialized.
+  plugin->channel =
+      new_method_channel(plugin, "window_manager_plus", method_call_cb);
+  plugin->static_channel = new_method_channel(
+      plugin, "window_manager_plus_static", static_method_call_cb);
+
+  // The reference from g_object_new belongs to the window and is released in
+  // on_window_destroy.
+}
+
+void window_manager_plus_plugin_set_window_created_callback(
+    WindowManagerPlusPluginWindowCreatedCallback callback) {
+  window_created_callback = callback;
+}
+
+int32_t WindowManagerPlusPluginDrainEvents(int64_t window_id,
+                                           WindowManagerPlusEvent* out,
+                                           int32_t capacity) {
+  if (out == nullptr || capacity <= 0)
+    return 0;
+
+  std::shared_ptr<WindowEventRing> ring;
+  {
+    std::lock_guard<std::mutex> lock(event_ring_mutex);
+    auto it = event_rings.find(window_id);
+    if (it != event_rings.end())
+      ring = it->second;
+  }
+  if (ring == nullptr)
+    return 0;
+  return static_cast<int32_t>(
+      ring->Drain(out, static_cast<size_t>(capacity)));
+}
+
+WindowManagerPlusEvent* WindowManagerPlusPluginAllocateEvents(
+    int32_t capacity) {
+  if (capacity <= 0)
+    return nullptr;
+  return g_try_new0(WindowManagerPlusEvent, capacity);
+}
+
+void WindowManagerPlusPluginFreeEvents(void* events) {
+  g_free(events);
+}
@@ -0,0 +1,75 @@
+import 'dart:ui';
+
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const MethodChannel staticChannel =
+      MethodChannel('window_manager_plus_static');
+
+  // Answers [method] on the static channel with [result], which goes through
+  // the standard codec like a reply of the native plugin.
+  void mockStaticMethod(String method, Object? result) {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, (MethodCall call) async {
+      expect(call.method, method);
+      return result;
+    });
+  }
+
+  tearDown(() {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, null);
+  });
+
+  test('getDisplays parses every display', () async {
+    mockStaticMethod('getDisplays', <Object?>[
+      <String, Object?>{
+        'id': r'\\.\DISPLAY1',
+        'x': 0.0,
+        'y': 0.0,
+        'width': 1920.0,
+        'height': 1080.0,
+        'visibleX': 0.0,
+        'visibleY': 0.0,
+        'visibleWidth': 1920.0,
+        'visibleHeight': 1040.0,
+        'scaleFactor': 1.0,
+        'refreshRate': 60,
+        'isPrimary': true,
+        'hasCursor': false,
+      },
+      <String, Object?>{
+        'id': r'\\.\DISPLAY2',
+        'x': 1920.0,
+        'y': -200.0,
+        'width': 1280.0,
+        'height': 720.0,
+        'visibleX': 1920.0,
+        'visibleY': -200.0,
+        'visibleWidth': 1280.0,
+        'visibleHeight': 720.0,
+        'scaleFactor': 1.5,
+        'refreshRate': 144,
+        'isPrimary': false,
+        'hasCursor': true,
+      },
+    ]);
+
+    final List<DisplayInfo> displays = await WindowManagerPlus.getDisplays();
+
+    expect(displays, hasLength(2));
+    expect(displays[0].id, r'\\.\DISPLAY1');
+    expect(displays[0].bounds, const Rect.fromLTWH(0, 0, 1920, 1080));
+    expect(displays[0].visibleBounds, const Rect.fromLTWH(0, 0, 1920, 1040));
+    expect(displays[0].isPrimary, isTrue);
+    expect(displays[0].hasCursor, isFalse);
+    expect(displays[1].bounds, const Rect.fromLTWH(1920, -200, 1280, 720));
+    expect(displays[1].scaleFactor, 1.5);
+    expect(displays[1].refreshRate, 144);
+    expect(displays[1].hasCursor, isTrue);
+  });
+}
@@ -0,0 +1,122 @@
+#include "event_ring_buffer.h"
+
+#include <cstdint>
+#include <thread>
+
+#include "test_util.h"
+
+namespace {
+
+struct Record {
+  int32_t id;
+  double value;
+};
+
+using Ring = window_manager_plus::EventRingBuffer<Record, 8>;
+
+TEST(DrainsNothingWhenEmpty) {
+  Ring ring;
+  Record out[Ring::kCapacity];
+  EXPECT_EQ(ring.Drain(out, Ring::kCapacity), 0u);
+}
+
+TEST(DrainsOldestFirst) {
+  Ring ring;
+  for (int32_t i = 0; i < 5; i++) {
+    EXPECT_TRUE(ring.Push({i, i * 0.5}));
+  }
+  Record out[Ring::kCapacity];
+  EXPECT_EQ(ring.Drain(out, Ring::kCapacity), 5u);
+  for (int32_t i = 0; i < 5; i++) {
+    EXPECT_EQ(out[i].id, i);
+    EXPECT_EQ(out[i].value, i * 0.5);
+  }
+  EXPECT_EQ(ring.Drain(out, Ring::kCapacity), 0u);
+}
+
+TEST(DrainStopsAtMaxCount) {
+  Ring ring;
+  for (int32_t i = 0; i < 6; i++) {
+    ring.Push({i, 0});
+  }
+  Record out[Ring::kCapacity];
+  EXPECT_EQ(ring.Drain(out, 4), 4u);
+  EXPECT_EQ(out[3].id, 3);
+  EXPECT_EQ(ring.Drain(out, 4), 2u);
+  EXPECT_EQ(out[0].id, 4);
+  EXPECT_EQ(out[1].id, 5);
+}
+
+TEST(FullRingDropsNewRecords) {
+  Ring ring;
+  for (int32_t i = 0; i < static_cast<int32_t>(Ring::kCapacity); i++) {
+    EXPECT_TRUE(ring.Push({i, 0}));
+  }
+  EXPECT_FALSE(ring.Push({100, 0}));
+
+  // The records that made it are intact, and draining one makes room.
+  Record out[Ring::kCapacity];
+  EXPECT_EQ(ring.Drain(out, 1), 1u);
+  EXPECT_EQ(out[0].id, 0);
+  EXPECT_TRUE(ring.Push({101, 0}));
+  EXPECT_FALSE(ring.Push({102, 0}));
+  EXPECT_EQ(ring.Drain(out, Ring::kCapacity), Ring::kCapacity);
+  EXPECT_EQ(out[0].id, 1);
+  EXPECT_EQ(out[Ring::kCapacity - 1].id, 101);
+}
+
+TEST(WrapsAround) {
+  Ring ring;
+  Record out[Ring::kCapacity];
+  int32_t next_push = 0;
+  int32_t next_drain = 0;
+  // Push and drain in uneven steps so the indices wrap many times at
+  // different offsets.
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < 5; i++) {
+      EXPECT_TRUE(ring.Push({next_push++, 0}));
+    }
+    size_t count = ring.Drain(out, 3 + round % 3);
+    for (size_t i = 0; i < count; i++) {
+      EXPECT_EQ(out[i].id, next_drain++);
+    }
+    count = ring.Drain(out, Ring::kCapacity);
+    for (size_t i = 0; i < count; i++) {
+      EXPECT_EQ(out[i].id, next_drain++);
+    }
+  }
+  EXPECT_EQ(next_drain, next_push);
+}
+
+TEST(ConsumerThreadSeesEveryRecordInOrder) {
+  constexpr int32_t kCount = 100000;
+  Ring ring;
+  bool in_order = true;
+  std::thread consumer([&] {
+    Record out[Ring::kCapacity];
+    int32_t expected = 0;
+    while (expected < kCount) {
+      size_t count = ring.Drain(out, Ring::kCapacity);
+      for (size_t i = 0; i < count; i++) {
+        in_order = in_order && out[i].id == expected;
+        expected++;
+      }
+      if (count == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  for (int32_t i = 0; i < kCount; i++) {
+    while (!ring.Push({i, 0})) {
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+  EXPECT_TRUE(in_order);
+}
+
+}  // namespace
+
+int main() {
+  return window_manager_plus::testing::RunAllTests();
+}
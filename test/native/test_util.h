@@ -0,0 +1,71 @@
+#ifndef WINDOW_MANAGER_PLUS_TEST_NATIVE_TEST_UTIL_H_
+#define WINDOW_MANAGER_PLUS_TEST_NATIVE_TEST_UTIL_H_
+
+#include <cstdio>
+#include <vector>
+
+// A minimal test harness, so the native tests build with nothing but a C++17
+// compiler. TEST registers a function, main() calls RunAllTests().
+
+namespace window_manager_plus {
+namespace testing {
+
+struct TestCase {
+  const char* name;
+  void (*function)();
+};
+
+inline std::vector<TestCase>& TestCases() {
+  static std::vector<TestCase> test_cases;
+  return test_cases;
+}
+
+inline int& FailureCount() {
+  static int failure_count = 0;
+  return failure_count;
+}
+
+struct TestRegistrar {
+  TestRegistrar(const char* name, void (*function)()) {
+    TestCases().push_back({name, function});
+  }
+};
+
+// Runs every registered test and returns the process exit code.
+inline int RunAllTests() {
+  int failed_tests = 0;
+  for (const TestCase& test_case : TestCases()) {
+    int failures_before = FailureCount();
+    test_case.function();
+    bool passed = FailureCount() == failures_before;
+    printf("[%s] %s\n", passed ? "  OK  " : " FAIL ", test_case.name);
+    if (!passed) {
+      failed_tests++;
+    }
+  }
+  printf("%zu tests, %d failed\n", TestCases().size(), failed_tests);
+  return failed_tests == 0 ? 0 : 1;
+}
+
+}  // namespace testing
+}  // namespace window_manager_plus
+
+#define TEST(name)                                                     \
+  static void name();                                                  \
+  static window_manager_plus::testing::TestRegistrar name##_registrar( \
+      #name, name);                                                    \
+  static void name()
+
+#define EXPECT_TRUE(condition)                                       \
+  do {                                                               \
+    if (!(condition)) {                                              \
+      fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__,    \
+              #condition);                                           \
+      window_manager_plus::testing::FailureCount()++;                \
+    }                                                                \
+  } while (0)
+
+#define EXPECT_FALSE(condition) EXPECT_TRUE(!(condition))
+#define EXPECT_EQ(a, b) EXPECT_TRUE((a) == (b))
+
+#endif  // WINDOW_MANAGER_PLUS_TEST_NATIVE_TEST_UTIL_H_
@@ -0,0 +1,148 @@
+#include "window_registry.h"
+
+#include <memory>
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+struct FakeWindow {};
+struct FakeManager {};
+
+using Registry =
+    window_manager_plus::WindowRegistry<FakeWindow, FakeManager>;
+
+constexpr int kSlotBits = 16;
+
+TEST(FirstIdsCountUpFromOne) {
+  Registry registry;
+  EXPECT_EQ(registry.Add(), 1);
+  EXPECT_EQ(registry.Add(), 2);
+  EXPECT_EQ(registry.Add(), 3);
+}
+
+TEST(FindsWhatWasSet) {
+  Registry registry;
+  int64_t id = registry.Add();
+  auto window = std::make_shared<FakeWindow>();
+  auto manager = std::make_shared<FakeManager>();
+  EXPECT_TRUE(registry.SetWindow(id, window));
+  EXPECT_TRUE(registry.SetManager(id, manager));
+  EXPECT_EQ(registry.FindWindow(id), window);
+  EXPECT_EQ(registry.FindManager(id), manager);
+}
+
+TEST(UnknownIdsFindNothing) {
+  Registry registry;
+  int64_t id = registry.Add();
+  EXPECT_EQ(registry.FindManager(-1), nullptr);
+  EXPECT_EQ(registry.FindManager(id + 1), nullptr);
+  EXPECT_FALSE(registry.SetManager(id + 1, std::make_shared<FakeManager>()));
+  EXPECT_EQ(registry.Remove(id + 1), nullptr);
+}
+
+TEST(RemoveReturnsTheWindow) {
+  Registry registry;
+  int64_t id = registry.Add();
+  auto window = std::make_shared<FakeWindow>();
+  registry.SetWindow(id, window);
+  registry.SetManager(id, std::make_shared<FakeManager>());
+  EXPECT_EQ(registry.Remove(id), window);
+  EXPECT_EQ(registry.FindWindow(id), nullptr);
+  EXPECT_EQ(registry.FindManager(id), nullptr);
+}
+
+TEST(ReusedSlotGetsNewGeneration) {
+  Registry registry;
+  int64_t first = registry.Add();
+  registry.SetManager(first, std::make_shared<FakeManager>());
+  registry.Remove(first);
+
+  int64_t second = registry.Add();
+  auto manager = std::make_shared<FakeManager>();
+  registry.SetManager(second, manager);
+
+  // Same slot, so the registry stays dense, but a different id.
+  EXPECT_EQ(second & ((int64_t{1} << kSlotBits) - 1), first);
+  EXPECT_EQ(second >> kSlotBits, 1);
+  EXPECT_TRUE(second != first);
+  // The id of the closed window doesn't resolve to the new one.
+  EXPECT_EQ(registry.FindManager(first), nullptr);
+  EXPECT_FALSE(registry.SetManager(first, std::make_shared<FakeManager>()));
+  EXPECT_EQ(registry.Remove(first), nullptr);
+  EXPECT_EQ(registry.FindManager(second), manager);
+}
+
+// The plugin answers INVALID_WINDOW_ID when FindManager returns nothing, so
+// every id that isn't live must miss, not just ids past the last slot.
+TEST(StaleIdsFindNothing) {
+  Registry registry;
+  int64_t id = registry.Add();
+  registry.SetManager(id, std::make_shared<FakeManager>());
+  int64_t next_generation = id + (int64_t{1} << kSlotBits);
+  EXPECT_EQ(registry.FindManager(next_generation), nullptr);
+
+  // Closed, and its slot not handed out again yet.
+  registry.Remove(id);
+  EXPECT_EQ(registry.FindManager(id), nullptr);
+  EXPECT_EQ(registry.FindWindow(id), nullptr);
+  EXPECT_EQ(registry.FindManager(next_generation), nullptr);
+}
+
+TEST(MainWindowSlotIsOnlyCleared) {
+  Registry registry;
+  auto manager = std::make_shared<FakeManager>();
+  EXPECT_TRUE(registry.SetManager(Registry::kMainWindowId, manager));
+  registry.Remove(Registry::kMainWindowId);
+  EXPECT_EQ(registry.FindManager(Registry::kMainWindowId), nullptr);
+
+  // The main window keeps id 0 and its slot is never handed out.
+  EXPECT_TRUE(registry.SetManager(Registry::kMainWindowId, manager));
+  EXPECT_EQ(registry.FindManager(Registry::kMainWindowId), manager);
+  EXPECT_EQ(registry.Add(), 1);
+}
+
+TEST(ForEachManagerVisitsLiveManagersInSlotOrder) {
+  Registry registry;
+  registry.SetManager(Registry::kMainWindowId,
+                      std::make_shared<FakeManager>());
+  int64_t a = registry.Add();
+  int64_t b = registry.Add();
+  int64_t c = registry.Add();
+  registry.SetManager(a, std::make_shared<FakeManager>());
+  registry.SetManager(b, std::make_shared<FakeManager>());
+  registry.SetManager(c, std::make_shared<FakeManager>());
+  registry.Remove(b);
+  // Added without a manager yet, like a window whose engine is starting.
+  int64_t d = registry.Add();
+
+  std::vector<int64_t> ids;
+  registry.ForEachManager(
+      [&](int64_t id, const std::shared_ptr<FakeManager>& manager) {
+        EXPECT_TRUE(manager != nullptr);
+        ids.push_back(id);
+      });
+  EXPECT_EQ(ids, (std::vector<int64_t>{Registry::kMainWindowId, a, c}));
+  EXPECT_TRUE(d != b);
+}
+
+TEST(RunsOutOfSlots) {
+  Registry registry;
+  int64_t last = 0;
+  for (int i = 1; i < (1 << kSlotBits); i++) {
+    last = registry.Add();
+  }
+  EXPECT_EQ(last, (1 << kSlotBits) - 1);
+  EXPECT_EQ(registry.Add(), -1);
+
+  // A removed window frees its slot again.
+  registry.Remove(last);
+  EXPECT_TRUE(registry.Add() >= 0);
+}
+
+}  // namespace
+
+int main() {
+  return window_manager_plus::testing::RunAllTests();
+}
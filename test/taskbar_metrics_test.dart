@@ -0,0 +1,31 @@
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const MethodChannel staticChannel =
+      MethodChannel('window_manager_plus_static');
+
+  tearDown(() {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, null);
+  });
+
+  test('getTaskbarMetrics converts milliseconds to a duration', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, (MethodCall call) async {
+      expect(call.method, 'getTaskbarMetrics');
+      return <String, Object?>{
+        'creationTime': 1.25,
+        'creationCount': 2,
+      };
+    });
+
+    final TaskbarMetrics metrics = await WindowManagerPlus.getTaskbarMetrics();
+
+    expect(metrics.creationTime, const Duration(microseconds: 1250));
+    expect(metrics.creationCount, 2);
+  });
+}
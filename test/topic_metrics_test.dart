@@ -0,0 +1,52 @@
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const MethodChannel staticChannel =
+      MethodChannel('window_manager_plus_static');
+
+  // Answers [method] on the static channel with [result], which goes through
+  // the standard codec like a reply of the native plugin.
+  void mockStaticMethod(String method, Object? result) {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, (MethodCall call) async {
+      expect(call.method, method);
+      return result;
+    });
+  }
+
+  tearDown(() {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, null);
+  });
+
+  test('getTopicMetrics parses the metrics of every topic', () async {
+    mockStaticMethod('getTopicMetrics', <String, Object?>{
+      'theme': <String, Object?>{
+        'subscribers': 3,
+        'published': 10,
+        'delivered': 24,
+        'coalesced': 2,
+      },
+      'selection': <String, Object?>{
+        'subscribers': 0,
+        'published': 1,
+        'delivered': 0,
+        'coalesced': 0,
+      },
+    });
+
+    final Map<String, TopicMetrics> metrics =
+        await WindowManagerPlus.getTopicMetrics();
+
+    expect(metrics.keys, unorderedEquals(<String>['theme', 'selection']));
+    expect(metrics['theme']!.subscribers, 3);
+    expect(metrics['theme']!.published, 10);
+    expect(metrics['theme']!.delivered, 24);
+    expect(metrics['theme']!.coalesced, 2);
+    expect(metrics['selection']!.delivered, 0);
+  });
+}
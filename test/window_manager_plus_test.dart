@@ -1,7 +0,0 @@
-import 'package:flutter/services.dart';
-import 'package:flutter_test/flutter_test.dart';
-import 'package:window_manager_plus/window_manager_plus.dart';
-
-void main() {
-
-}
@@ -0,0 +1,48 @@
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const MethodChannel staticChannel =
+      MethodChannel('window_manager_plus_static');
+
+  // Answers [method] on the static channel with [result], which goes through
+  // the standard codec like a reply of the native plugin.
+  void mockStaticMethod(String method, Object? result) {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, (MethodCall call) async {
+      expect(call.method, method);
+      return result;
+    });
+  }
+
+  tearDown(() {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(staticChannel, null);
+  });
+
+  test('getWindowPoolMetrics converts milliseconds to durations', () async {
+    mockStaticMethod('getWindowPoolMetrics', <String, Object?>{
+      'size': 2,
+      'ready': 1,
+      'warming': 1,
+      'hits': 5,
+      'misses': 3,
+      'pooledTimeToFirstFrame': 12.5,
+      'unpooledTimeToFirstFrame': 250.0,
+    });
+
+    final WindowPoolMetrics metrics =
+        await WindowManagerPlus.getWindowPoolMetrics();
+
+    expect(metrics.size, 2);
+    expect(metrics.ready, 1);
+    expect(metrics.warming, 1);
+    expect(metrics.hits, 5);
+    expect(metrics.misses, 3);
+    expect(metrics.pooledTimeToFirstFrame, const Duration(microseconds: 12500));
+    expect(metrics.unpooledTimeToFirstFrame, const Duration(milliseconds: 250));
+  });
+}
@@ -0,0 +1,16 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+void main() {
+  test('WindowRefreshMetrics.fromJson defaults missing size resends', () {
+    final Map<String, dynamic> json = <String, dynamic>{
+      'refreshes': 3,
+      'surfaceResizes': 1,
+    };
+    final WindowRefreshMetrics metrics = WindowRefreshMetrics.fromJson(json);
+
+    expect(metrics.refreshes, 3);
+    expect(metrics.surfaceResizes, 1);
+    expect(metrics.sizeResends, 0);
+  });
+}
@@ -0,0 +1,33 @@
+import 'dart:ui';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:window_manager_plus/window_manager_plus.dart';
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  test('WindowState.fromJson reads bounds and flags', () {
+    final WindowState state = WindowState.fromJson(<String, dynamic>{
+      'x': 10.0,
+      'y': 20.0,
+      'width': 800.0,
+      'height': 600.0,
+      'isMaximized': false,
+      'isMinimized': false,
+      'isFullScreen': true,
+      'isFocused': true,
+      'isVisible': true,
+      'isAlwaysOnTop': false,
+      'opacity': 0.5,
+    });
+
+    expect(state.bounds, const Rect.fromLTWH(10, 20, 800, 600));
+    expect(state.isMaximized, isFalse);
+    expect(state.isMinimized, isFalse);
+    expect(state.isFullScreen, isTrue);
+    expect(state.isFocused, isTrue);
+    expect(state.isVisible, isTrue);
+    expect(state.isAlwaysOnTop, isFalse);
+    expect(state.opacity, 0.5);
+  });
+}
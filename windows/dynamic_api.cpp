@@ -0,0 +1,35 @@
+#include "dynamic_api.h"
+
+namespace window_manager_plus {
+
+namespace {
+
+DynamicApi Resolve() {
+  DynamicApi api;
+  // user32.dll and ntdll.dll are loaded in every GUI process, shcore.dll is
+  // loaded here and never freed.
+  if (HMODULE user32 = GetModuleHandle(L"user32.dll")) {
+    api.set_window_composition_attribute =
+        reinterpret_cast<SetWindowCompositionAttributeFunc>(
+            GetProcAddress(user32, "SetWindowCompositionAttribute"));
+  }
+  if (HMODULE shcore = LoadLibrary(L"shcore.dll")) {
+    api.get_dpi_for_monitor = reinterpret_cast<GetDpiForMonitorFunc>(
+        GetProcAddress(shcore, "GetDpiForMonitor"));
+  }
+  if (HMODULE ntdll = GetModuleHandle(L"ntdll.dll")) {
+    api.rtl_get_version = reinterpret_cast<RtlGetVersionFunc>(
+        GetProcAddress(ntdll, "RtlGetVersion"));
+  }
+  return api;
+}
+
+}  // namespace
+
+// static
+const DynamicApi& DynamicApi::Get() {
+  static const DynamicApi api = Resolve();
+  return api;
+}
+
+}  // namespace window_manager_plus
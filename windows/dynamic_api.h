@@ -0,0 +1,39 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_DYNAMIC_API_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_DYNAMIC_API_H_
+
+#include <windows.h>
+
+namespace window_manager_plus {
+
+// The argument of SetWindowCompositionAttribute, which user32 exports
+// without declaring it.
+struct WindowCompositionAttributeData {
+  int attribute;
+  PVOID data;
+  ULONG data_size;
+};
+
+typedef BOOL(WINAPI* SetWindowCompositionAttributeFunc)(
+    HWND,
+    WindowCompositionAttributeData*);
+typedef HRESULT(WINAPI* GetDpiForMonitorFunc)(HMONITOR, int, UINT*, UINT*);
+typedef LONG(WINAPI* RtlGetVersionFunc)(PRTL_OSVERSIONINFOW);
+
+// Entry points that are undocumented or missing on older Windows versions,
+// looked up once per process instead of with LoadLibrary / GetProcAddress /
+// FreeLibrary on every call. A member is null if it is not available. The
+// modules they come from stay loaded for the lifetime of the process.
+struct DynamicApi {
+  static const DynamicApi& Get();
+
+  SetWindowCompositionAttributeFunc set_window_composition_attribute =
+      nullptr;
+  // shcore.dll, Windows 8.1 and later.
+  GetDpiForMonitorFunc get_dpi_for_monitor = nullptr;
+  // Reports the real OS version whatever the application manifest declares.
+  RtlGetVersionFunc rtl_get_version = nullptr;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_DYNAMIC_API_H_
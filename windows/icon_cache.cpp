@@ -0,0 +1,300 @@
+#include "icon_cache.h"
+
+#include <bcrypt.h>
+
+#include <algorithm>
+#include <iostream>
+
+#pragma comment(lib, "bcrypt.lib")
+
+namespace window_manager_plus {
+
+namespace {
+
+// The icon sizes at 96 DPI.
+constexpr int kSmallIconSize = 16;
+constexpr int kBigIconSize = 32;
+
+std::wstring Utf8ToWide(const std::string& utf8) {
+  int length = MultiByteToWideChar(CP_UTF8, 0, utf8.data(),
+                                   static_cast<int>(utf8.size()), nullptr, 0);
+  std::wstring wide(length, L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()),
+                      wide.data(), length);
+  return wide;
+}
+
+// Returns the SHA-256 of |bytes| in hex, or an empty string if BCrypt
+// fails.
+std::string Sha256(const std::vector<uint8_t>& bytes) {
+  BCRYPT_ALG_HANDLE algorithm = nullptr;
+  if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(
+          &algorithm, BCRYPT_SHA256_ALGORITHM, nullptr, 0))) {
+    return std::string();
+  }
+  BCRYPT_HASH_HANDLE hash = nullptr;
+  UCHAR digest[32];
+  bool hashed =
+      BCRYPT_SUCCESS(
+          BCryptCreateHash(algorithm, &hash, nullptr, 0, nullptr, 0, 0)) &&
+      BCRYPT_SUCCESS(BCryptHashData(hash, const_cast<PUCHAR>(bytes.data()),
+                                    static_cast<ULONG>(bytes.size()), 0)) &&
+      BCRYPT_SUCCESS(BCryptFinishHash(hash, digest, sizeof(digest), 0));
+  if (hash != nullptr)
+    BCryptDestroyHash(hash);
+  BCryptCloseAlgorithmProvider(algorithm, 0);
+  if (!hashed)
+    return std::string();
+
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  std::string hex;
+  for (UCHAR byte : digest) {
+    hex += kHexDigits[byte >> 4];
+    hex += kHexDigits[byte & 0xf];
+  }
+  return hex;
+}
+
+std::string MakeKey(const IconSource& source, UINT dpi) {
+  std::string key;
+  if (source.bytes.empty()) {
+    key = "path:" + source.path;
+  } else {
+    // A digest rather than a hash, so two images never share an entry. The
+    // bytes themselves are the key in the unlikely case BCrypt fails.
+    std::string digest = Sha256(source.bytes);
+    key = "bytes:" + (digest.empty() ? std::string(source.bytes.begin(),
+                                                   source.bytes.end())
+                                     : digest);
+  }
+  return key + "@" + std::to_string(dpi);
+}
+
+// Returns the image of the ICO file |data| that fits |size| best, the
+// smallest one at least as large or else the largest, in the format
+// CreateIconFromResourceEx takes.
+bool FindIcoImage(const std::vector<uint8_t>& data,
+                  int size,
+                  const uint8_t** image,
+                  DWORD* image_size) {
+  auto read_word = [&](size_t offset) {
+    return static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+  };
+  auto read_dword = [&](size_t offset) {
+    return static_cast<uint32_t>(read_word(offset)) |
+           (static_cast<uint32_t>(read_word(offset + 2)) << 16);
+  };
+
+  // ICONDIR is 6 bytes, followed by one 16 byte ICONDIRENTRY per image.
+  size_t count = read_word(4);
+  if (data.size() < 6 + count * 16)
+    return false;
+
+  size_t best = count;
+  int best_width = 0;
+  for (size_t i = 0; i < count; i++) {
+    // A width of 0 stands for 256.
+    int width = data[6 + i * 16] != 0 ? data[6 + i * 16] : 256;
+    bool fits = width >= size;
+    bool best_fits = best_width >= size;
+    if (best == count || (fits && (!best_fits || width < best_width)) ||
+        (!fits && !best_fits && width > best_width)) {
+      best = i;
+      best_width = width;
+    }
+  }
+  if (best == count)
+    return false;
+
+  uint32_t length = read_dword(6 + best * 16 + 8);
+  uint32_t offset = read_dword(6 + best * 16 + 12);
+  if (offset > data.size() || length > data.size() - offset)
+    return false;
+  *image = data.data() + offset;
+  *image_size = length;
+  return true;
+}
+
+HICON LoadIconAtSize(const IconSource& source, int size) {
+  if (source.bytes.empty()) {
+    std::wstring path = Utf8ToWide(source.path);
+    return static_cast<HICON>(LoadImage(nullptr, path.c_str(), IMAGE_ICON,
+                                        size, size, LR_LOADFROMFILE));
+  }
+
+  const std::vector<uint8_t>& bytes = source.bytes;
+  const uint8_t* image = bytes.data();
+  DWORD image_size = static_cast<DWORD>(bytes.size());
+  // An ICO file starts with a reserved 0 and the type 1. Anything else is
+  // handed over as it is, CreateIconFromResourceEx takes PNG data directly.
+  bool is_ico = bytes.size() >= 6 && bytes[0] == 0 && bytes[1] == 0 &&
+                bytes[2] == 1 && bytes[3] == 0;
+  if (is_ico && !FindIcoImage(bytes, size, &image, &image_size))
+    return nullptr;
+
+  return CreateIconFromResourceEx(const_cast<PBYTE>(image), image_size, TRUE,
+                                  0x00030000, size, size, LR_DEFAULTCOLOR);
+}
+
+}  // namespace
+
+// static
+IconCache& IconCache::GetInstance() {
+  // Never destroyed, windows still release their icons while the process
+  // exits. The plugin stops the worker with Shutdown.
+  static IconCache* instance = new IconCache();
+  return *instance;
+}
+
+// static
+UINT IconCache::GetDecodedMessage() {
+  static UINT message =
+      RegisterWindowMessage(L"WINDOW_MANAGER_PLUS_ICON_DECODED");
+  return message;
+}
+
+std::string IconCache::Request(const IconSource& source,
+                               UINT dpi,
+                               HWND hwnd) {
+  std::string key = MakeKey(source, dpi);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = entries_.try_emplace(key);
+  Entry& entry = it->second;
+  entry.references++;
+  entry.last_used = ++use_count_;
+  if (entry.is_decoded)
+    return key;
+
+  if (std::find(entry.waiting_windows.begin(), entry.waiting_windows.end(),
+                hwnd) == entry.waiting_windows.end()) {
+    entry.waiting_windows.push_back(hwnd);
+  }
+  if (inserted) {
+    decode_queue_.push_back({key, source, dpi});
+    if (!worker_.joinable())
+      worker_ = std::thread(&IconCache::RunWorker, this);
+    decode_queue_changed_.notify_one();
+  }
+  return key;
+}
+
+bool IconCache::GetIcons(const std::string& key, IconPair* icons) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || !it->second.is_decoded)
+    return false;
+  *icons = it->second.icons;
+  it->second.last_used = ++use_count_;
+  return true;
+}
+
+void IconCache::Release(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end())
+    return;
+  if (it->second.references > 0)
+    it->second.references--;
+  // A failed decode is not kept, so the next Request tries again.
+  const Entry& entry = it->second;
+  if (entry.is_decoded && entry.icons.small_icon == nullptr &&
+      entry.references == 0) {
+    entries_.erase(it);
+  }
+  Trim();
+}
+
+void IconCache::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!worker_.joinable())
+      return;
+    is_shutting_down_ = true;
+  }
+  decode_queue_changed_.notify_all();
+  worker_.join();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_shutting_down_ = false;
+}
+
+void IconCache::RunWorker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    decode_queue_changed_.wait(lock, [this]() {
+      return is_shutting_down_ || !decode_queue_.empty();
+    });
+    if (is_shutting_down_)
+      return;
+    DecodeJob job = std::move(decode_queue_.front());
+    decode_queue_.pop_front();
+
+    lock.unlock();
+    OnDecoded(job.key, Decode(job.source, job.dpi));
+    lock.lock();
+  }
+}
+
+// static
+IconPair IconCache::Decode(const IconSource& source, UINT dpi) {
+  IconPair icons;
+  icons.small_icon = LoadIconAtSize(
+      source, MulDiv(kSmallIconSize, dpi, USER_DEFAULT_SCREEN_DPI));
+  icons.big_icon = LoadIconAtSize(
+      source, MulDiv(kBigIconSize, dpi, USER_DEFAULT_SCREEN_DPI));
+  return icons;
+}
+
+void IconCache::OnDecoded(const std::string& key, IconPair icons) {
+  // Half an icon pair is a failure too; both icons come from the same image.
+  if (icons.small_icon == nullptr || icons.big_icon == nullptr) {
+    std::cerr << "Failed to load icon " << key.substr(0, key.rfind('@'))
+              << std::endl;
+    if (icons.small_icon != nullptr)
+      DestroyIcon(icons.small_icon);
+    if (icons.big_icon != nullptr)
+      DestroyIcon(icons.big_icon);
+    icons = IconPair();
+  }
+
+  std::vector<HWND> waiting_windows;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Entries being decoded are never trimmed, see Trim.
+    auto it = entries_.find(key);
+    Entry& entry = it->second;
+    entry.icons = icons;
+    entry.is_decoded = true;
+    waiting_windows.swap(entry.waiting_windows);
+    if (icons.small_icon == nullptr && entry.references == 0)
+      entries_.erase(it);
+  }
+  for (HWND hwnd : waiting_windows) {
+    PostMessage(hwnd, GetDecodedMessage(), 0, 0);
+  }
+}
+
+void IconCache::Trim() {
+  std::vector<std::map<std::string, Entry>::iterator> unused;
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->second.is_decoded && it->second.references == 0)
+      unused.push_back(it);
+  }
+  if (unused.size() <= kMaxUnusedEntries)
+    return;
+
+  std::sort(unused.begin(), unused.end(), [](const auto& a, const auto& b) {
+    return a->second.last_used < b->second.last_used;
+  });
+  for (size_t i = 0; i < unused.size() - kMaxUnusedEntries; i++) {
+    const IconPair& icons = unused[i]->second.icons;
+    if (icons.small_icon != nullptr)
+      DestroyIcon(icons.small_icon);
+    if (icons.big_icon != nullptr)
+      DestroyIcon(icons.big_icon);
+    entries_.erase(unused[i]);
+  }
+}
+
+}  // namespace window_manager_plus
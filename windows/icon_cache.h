@@ -0,0 +1,108 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_ICON_CACHE_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_ICON_CACHE_H_
+
+#include <windows.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace window_manager_plus {
+
+// Where the icons of setIcon come from: a file (UTF-8 path) or the bytes of
+// a PNG or ICO image.
+struct IconSource {
+  std::string path;
+  std::vector<uint8_t> bytes;
+};
+
+// The small and big icons of a window, sized for one DPI.
+struct IconPair {
+  HICON small_icon = nullptr;
+  HICON big_icon = nullptr;
+};
+
+// Process-wide cache of window icons, keyed by source, size and DPI.
+//
+// Icons are decoded one after the other on a worker thread, so setIcon never
+// reads or decodes an image on the platform thread. When a decode is done,
+// every window waiting for it is posted GetDecodedMessage(), and picks the
+// icons up with GetIcons on its own thread. The cache owns the HICONs: a
+// window holds a reference to the entries it shows or waits for, and entries
+// nobody references are destroyed once there are more than
+// kMaxUnusedEntries of them. Failed decodes are dropped as soon as nobody
+// references them, so asking again retries.
+class IconCache {
+ public:
+  static IconCache& GetInstance();
+
+  // The message posted to the windows waiting for a decode.
+  static UINT GetDecodedMessage();
+
+  // Returns the key of |source| at |dpi| with a reference to its entry, and
+  // starts decoding it unless it is cached or already being decoded. |hwnd|
+  // is posted GetDecodedMessage() when the icons are ready, if they are not
+  // yet.
+  std::string Request(const IconSource& source, UINT dpi, HWND hwnd);
+
+  // Returns false if the icons of |key| are still being decoded. They are
+  // null if decoding failed.
+  bool GetIcons(const std::string& key, IconPair* icons);
+
+  // Drops the reference taken by Request.
+  void Release(const std::string& key);
+
+  // Stops the worker thread once the decode it is running is done. Decodes
+  // still queued are left for the next Request, which starts a new worker.
+  void Shutdown();
+
+ private:
+  IconCache() = default;
+
+  static constexpr size_t kMaxUnusedEntries = 16;
+
+  struct Entry {
+    IconPair icons;
+    bool is_decoded = false;
+    int64_t references = 0;
+    // For evicting the least recently used entries first.
+    uint64_t last_used = 0;
+    std::vector<HWND> waiting_windows;
+  };
+
+  struct DecodeJob {
+    std::string key;
+    IconSource source;
+    UINT dpi;
+  };
+
+  static IconPair Decode(const IconSource& source, UINT dpi);
+
+  // Runs on worker_, decoding the jobs of decode_queue_ until Shutdown.
+  void RunWorker();
+
+  void OnDecoded(const std::string& key, IconPair icons);
+
+  // Destroys the least recently used unreferenced entries beyond
+  // kMaxUnusedEntries. Must be called with mutex_ held.
+  void Trim();
+
+  // The worker finishes decodes on its own, so the entries and the queue are
+  // behind a mutex.
+  std::mutex mutex_;
+  std::map<std::string, Entry> entries_;
+  uint64_t use_count_ = 0;
+  std::deque<DecodeJob> decode_queue_;
+  std::condition_variable decode_queue_changed_;
+  bool is_shutting_down_ = false;
+  std::thread worker_;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_ICON_CACHE_H_
@@ -2,6 +2,7 @@
 #define FLUTTER_PLUGIN_WINDOW_MANAGER_PLUS_PLUGIN_H_
 
 #include <any>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -39,6 +40,66 @@ typedef std::shared_ptr<FlutterWindow> (
 FLUTTER_PLUGIN_EXPORT void WindowManagerPlusPluginSetWindowCreatedCallback(
     WindowManagerPlusPluginWindowCreatedCallback callback);
 
+#define WINDOW_MANAGER_PLUS_EVENT_MOVE 1
+#define WINDOW_MANAGER_PLUS_EVENT_RESIZE 2
+
+// An event recorded by the event fast path, see
+// WindowManagerPlus.setEventFastPath. The Dart side reads this layout through
+// dart:ffi.
+typedef struct {
+  // One of WINDOW_MANAGER_PLUS_EVENT_*.
+  int32_t event_id;
+  int32_t reserved;
+  int64_t window_id;
+  // Microseconds on a monotonic clock.
+  int64_t timestamp_us;
+  // The window bounds when the event was recorded, in physical pixels.
+  double x;
+  double y;
+  double width;
+  double height;
+} WindowManagerPlusEvent;
+
+// Moves up to |capacity| of the events recorded for |window_id| since the
+// last call into |out|, oldest first, and returns how many were moved.
+// Returns 0 if the event fast path is not enabled for the window.
+FLUTTER_PLUGIN_EXPORT int32_t
+WindowManagerPlusPluginDrainEvents(int64_t window_id,
+                                   WindowManagerPlusEvent* out,
+                                   int32_t capacity);
+
+// Returns a buffer for |capacity| events to drain into, or null on failure.
+// Free it with WindowManagerPlusPluginFreeEvents.
+FLUTTER_PLUGIN_EXPORT WindowManagerPlusEvent*
+WindowManagerPlusPluginAllocateEvents(int32_t capacity);
+
+// Frees a buffer returned by WindowManagerPlusPluginAllocateEvents. Takes a
+// void* so the Dart side can use it as a NativeFinalizer.
+FLUTTER_PLUGIN_EXPORT void WindowManagerPlusPluginFreeEvents(void* events);
+
+// Buffers shared between windows, see SharedWindowBuffer on the Dart side.
+// A buffer is identified by a non-zero id and freed when its last reference
+// is released.
+
+// Returns the id of a new zero-filled buffer of |size| bytes holding one
+// reference, or 0 on failure.
+FLUTTER_PLUGIN_EXPORT int64_t WindowManagerPlusPluginAllocateBuffer(
+    int64_t size);
+
+FLUTTER_PLUGIN_EXPORT uint8_t* WindowManagerPlusPluginGetBufferData(
+    int64_t buffer_id);
+
+FLUTTER_PLUGIN_EXPORT int64_t WindowManagerPlusPluginGetBufferSize(
+    int64_t buffer_id);
+
+FLUTTER_PLUGIN_EXPORT bool WindowManagerPlusPluginRetainBuffer(
+    int64_t buffer_id);
+
+// Takes the id as a pointer-sized token so it can be used as the callback of
+// a Dart NativeFinalizer.
+FLUTTER_PLUGIN_EXPORT void WindowManagerPlusPluginReleaseBuffer(
+    void* buffer_id);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
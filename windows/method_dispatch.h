@@ -0,0 +1,84 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_METHOD_DISPATCH_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_METHOD_DISPATCH_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace window_manager_plus {
+
+template <typename Handler>
+struct MethodDispatchEntry {
+  std::string_view name;
+  Handler handler = nullptr;
+};
+
+// Maps method channel names to their handlers.
+//
+// The table is built at compile time from entries sorted by name, so a lookup
+// is a binary search over string_views instead of a linear chain of string
+// compares. Use IsSorted() in a static_assert where the table is defined.
+template <typename Handler, std::size_t N>
+class MethodDispatchTable {
+ public:
+  constexpr explicit MethodDispatchTable(
+      const MethodDispatchEntry<Handler> (&entries)[N])
+      : entries_() {
+    for (std::size_t i = 0; i < N; i++) {
+      entries_[i] = entries[i];
+    }
+  }
+
+  constexpr bool IsSorted() const {
+    for (std::size_t i = 1; i < N; i++) {
+      if (!(entries_[i - 1].name < entries_[i].name)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns true if the table has exactly |names|, in the same order.
+  template <std::size_t M>
+  constexpr bool HasNames(const std::string_view (&names)[M]) const {
+    if (M != N) {
+      return false;
+    }
+    for (std::size_t i = 0; i < N; i++) {
+      if (entries_[i].name != names[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr std::size_t size() const { return N; }
+
+  // Returns the handler registered for |name|, or nullptr if there is none.
+  Handler Find(std::string_view name) const {
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), name,
+        [](const MethodDispatchEntry<Handler>& entry, std::string_view value) {
+          return entry.name < value;
+        });
+    if (it == entries_.end() || it->name != name) {
+      return nullptr;
+    }
+    return it->handler;
+  }
+
+ private:
+  std::array<MethodDispatchEntry<Handler>, N> entries_;
+};
+
+template <typename Handler, std::size_t N>
+constexpr MethodDispatchTable<Handler, N> MakeMethodDispatchTable(
+    const MethodDispatchEntry<Handler> (&entries)[N]) {
+  return MethodDispatchTable<Handler, N>(entries);
+}
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_METHOD_DISPATCH_H_
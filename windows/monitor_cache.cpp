@@ -0,0 +1,158 @@
+#include "monitor_cache.h"
+
+#include <algorithm>
+
+#include "dynamic_api.h"
+
+namespace window_manager_plus {
+
+namespace {
+
+LONG64 IntersectionArea(const RECT& a, const RECT& b) {
+  LONG64 width = (std::min)(a.right, b.right) - (std::max)(a.left, b.left);
+  LONG64 height = (std::min)(a.bottom, b.bottom) - (std::max)(a.top, b.top);
+  return width > 0 && height > 0 ? width * height : 0;
+}
+
+LONG64 DistanceSquared(const RECT& a, const RECT& b) {
+  LONG64 dx = (std::max)({0L, a.left - b.right, b.left - a.right});
+  LONG64 dy = (std::max)({0L, a.top - b.bottom, b.top - a.bottom});
+  return dx * dx + dy * dy;
+}
+
+}  // namespace
+
+// static
+MonitorCache& MonitorCache::GetInstance() {
+  static MonitorCache instance;
+  return instance;
+}
+
+const std::vector<MonitorInfo>& MonitorCache::GetMonitors() {
+  EnsureValid();
+  return monitors_;
+}
+
+MonitorInfo MonitorCache::FromRect(const RECT& rect) {
+  EnsureValid();
+  const MonitorInfo* best = &monitors_.front();
+  LONG64 best_area = -1;
+  for (const auto& info : monitors_) {
+    LONG64 area = IntersectionArea(rect, info.monitor_rect);
+    if (area > best_area) {
+      best = &info;
+      best_area = area;
+    }
+  }
+  if (best_area > 0) {
+    return *best;
+  }
+
+  LONG64 best_distance = -1;
+  for (const auto& info : monitors_) {
+    LONG64 distance = DistanceSquared(rect, info.monitor_rect);
+    if (best_distance < 0 || distance < best_distance) {
+      best = &info;
+      best_distance = distance;
+    }
+  }
+  return *best;
+}
+
+MonitorInfo MonitorCache::FromWindow(HWND hwnd) {
+  HMONITOR monitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
+  for (int attempt = 0; attempt < 2; attempt++) {
+    EnsureValid();
+    for (const auto& info : monitors_) {
+      if (info.monitor == monitor) {
+        return info;
+      }
+    }
+    // A monitor we have not seen yet, the topology changed before we were
+    // told about it.
+    Invalidate();
+  }
+  return GetPrimary();
+}
+
+MonitorInfo MonitorCache::GetPrimary() {
+  EnsureValid();
+  for (const auto& info : monitors_) {
+    if (info.is_primary) {
+      return info;
+    }
+  }
+  return monitors_.front();
+}
+
+void MonitorCache::Invalidate() {
+  is_valid_ = false;
+}
+
+void MonitorCache::EnsureValid() {
+  if (is_valid_) {
+    return;
+  }
+
+  monitors_.clear();
+  EnumDisplayMonitors(nullptr, nullptr, AddMonitor,
+                      reinterpret_cast<LPARAM>(this));
+
+  // GetDpiForMonitor is looked up at runtime to keep Windows 7 support.
+  if (GetDpiForMonitorFunc GetDpiForMonitor =
+          DynamicApi::Get().get_dpi_for_monitor) {
+    const int MDT_EFFECTIVE_DPI = 0;
+    for (auto& info : monitors_) {
+      UINT dpiX = 96;
+      UINT dpiY = 96;
+      if (SUCCEEDED(GetDpiForMonitor(info.monitor, MDT_EFFECTIVE_DPI, &dpiX,
+                                     &dpiY))) {
+        info.dpi = dpiX;
+      }
+    }
+  }
+
+  if (monitors_.empty()) {
+    // Keep the lookups total even if enumeration failed.
+    MonitorInfo info;
+    info.monitor_rect = {0, 0, GetSystemMetrics(SM_CXSCREEN),
+                         GetSystemMetrics(SM_CYSCREEN)};
+    info.work_area = info.monitor_rect;
+    info.is_primary = true;
+    monitors_.push_back(info);
+  }
+  is_valid_ = true;
+}
+
+// static
+BOOL CALLBACK MonitorCache::AddMonitor(HMONITOR monitor,
+                                       HDC hdc,
+                                       LPRECT rect,
+                                       LPARAM data) {
+  auto* cache = reinterpret_cast<MonitorCache*>(data);
+  MONITORINFOEX monitor_info = {};
+  monitor_info.cbSize = sizeof(MONITORINFOEX);
+  if (!GetMonitorInfo(monitor, &monitor_info)) {
+    return TRUE;
+  }
+
+  MonitorInfo info;
+  info.monitor = monitor;
+  info.device_name = monitor_info.szDevice;
+  info.monitor_rect = monitor_info.rcMonitor;
+  info.work_area = monitor_info.rcWork;
+  info.is_primary = (monitor_info.dwFlags & MONITORINFOF_PRIMARY) != 0;
+
+  DEVMODE dev_mode = {};
+  dev_mode.dmSize = sizeof(DEVMODE);
+  if (EnumDisplaySettings(monitor_info.szDevice, ENUM_CURRENT_SETTINGS,
+                          &dev_mode) &&
+      dev_mode.dmDisplayFrequency > 1) {
+    info.refresh_rate = dev_mode.dmDisplayFrequency;
+  }
+
+  cache->monitors_.push_back(std::move(info));
+  return TRUE;
+}
+
+}  // namespace window_manager_plus
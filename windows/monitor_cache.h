@@ -0,0 +1,66 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_MONITOR_CACHE_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_MONITOR_CACHE_H_
+
+#include <windows.h>
+
+#include <string>
+#include <vector>
+
+namespace window_manager_plus {
+
+struct MonitorInfo {
+  HMONITOR monitor = nullptr;
+  std::wstring device_name;
+  RECT monitor_rect = {};
+  RECT work_area = {};
+  UINT dpi = 96;
+  // In Hz, 0 if unknown.
+  UINT refresh_rate = 0;
+  bool is_primary = false;
+};
+
+// Process-wide snapshot of the monitor topology.
+//
+// WM_NCCALCSIZE, DPI and fullscreen handling used to call MonitorFromRect /
+// GetMonitorInfo / GetDpiForMonitor for every message. The snapshot is taken
+// once and kept until Invalidate() is called on WM_DISPLAYCHANGE,
+// WM_SETTINGCHANGE or WM_DPICHANGED, so those lookups become a scan over a
+// few RECTs.
+class MonitorCache {
+ public:
+  static MonitorCache& GetInstance();
+
+  // Valid until the next call that may dispatch messages, which can
+  // invalidate and rebuild the snapshot.
+  const std::vector<MonitorInfo>& GetMonitors();
+
+  // The lookups return copies, so callers can hold on to them across
+  // SetWindowPos and other calls that dispatch WM_DISPLAYCHANGE.
+
+  // Returns the monitor that intersects |rect| the most, or the nearest one
+  // if none does, like MonitorFromRect with MONITOR_DEFAULTTONEAREST.
+  MonitorInfo FromRect(const RECT& rect);
+
+  MonitorInfo FromWindow(HWND hwnd);
+
+  MonitorInfo GetPrimary();
+
+  void Invalidate();
+
+ private:
+  MonitorCache() = default;
+
+  void EnsureValid();
+
+  static BOOL CALLBACK AddMonitor(HMONITOR monitor,
+                                  HDC hdc,
+                                  LPRECT rect,
+                                  LPARAM data);
+
+  bool is_valid_ = false;
+  std::vector<MonitorInfo> monitors_;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_MONITOR_CACHE_H_
@@ -0,0 +1,78 @@
+#include "shared_buffer_arena.h"
+
+#include <new>
+
+namespace window_manager_plus {
+
+// static
+SharedBufferArena& SharedBufferArena::GetInstance() {
+  static SharedBufferArena instance;
+  return instance;
+}
+
+int64_t SharedBufferArena::Allocate(int64_t size) {
+  if (size < 0)
+    return 0;
+
+  Buffer buffer;
+  // Allocate at least one byte so an empty buffer still has a valid address.
+  buffer.data.reset(new (std::nothrow)
+                        uint8_t[size > 0 ? static_cast<size_t>(size) : 1]());
+  if (buffer.data == nullptr)
+    return 0;
+  buffer.size = size;
+  buffer.references = 1;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t id = next_id_++;
+  allocated_bytes_ += size;
+  buffers_.emplace(id, std::move(buffer));
+  return id;
+}
+
+uint8_t* SharedBufferArena::GetData(int64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.find(id);
+  return it != buffers_.end() ? it->second.data.get() : nullptr;
+}
+
+int64_t SharedBufferArena::GetSize(int64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.find(id);
+  return it != buffers_.end() ? it->second.size : 0;
+}
+
+bool SharedBufferArena::Retain(int64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.find(id);
+  if (it == buffers_.end())
+    return false;
+  it->second.references++;
+  return true;
+}
+
+void SharedBufferArena::Release(int64_t id) {
+  std::unique_ptr<uint8_t[]> data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buffers_.find(id);
+    if (it == buffers_.end() || --it->second.references > 0)
+      return;
+    data = std::move(it->second.data);
+    allocated_bytes_ -= it->second.size;
+    buffers_.erase(it);
+  }
+  // |data| is freed here, outside the lock.
+}
+
+size_t SharedBufferArena::GetBufferCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return buffers_.size();
+}
+
+int64_t SharedBufferArena::GetAllocatedBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return allocated_bytes_;
+}
+
+}  // namespace window_manager_plus
@@ -0,0 +1,60 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_SHARED_BUFFER_ARENA_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_SHARED_BUFFER_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace window_manager_plus {
+
+// Process-wide, reference counted byte buffers that windows hand to each
+// other by id instead of sending their contents over a method channel.
+//
+// Every engine maps a buffer's memory directly with dart:ffi, so a payload is
+// written once by the sender and read in place by the receiver. Buffers are
+// allocated, retained and released from the UI threads of several engines,
+// so the bookkeeping is behind a mutex; the memory itself is not locked.
+class SharedBufferArena {
+ public:
+  static SharedBufferArena& GetInstance();
+
+  // Returns the id of a new zero-filled buffer of |size| bytes with one
+  // reference, or 0 if it could not be allocated.
+  int64_t Allocate(int64_t size);
+
+  // Returns null if |id| is not a live buffer.
+  uint8_t* GetData(int64_t id);
+
+  // Returns 0 if |id| is not a live buffer.
+  int64_t GetSize(int64_t id);
+
+  // Returns false if |id| is not a live buffer.
+  bool Retain(int64_t id);
+
+  // Drops one reference to |id| and frees the buffer with the last one.
+  void Release(int64_t id);
+
+  // The number of live buffers and the bytes they hold.
+  size_t GetBufferCount();
+  int64_t GetAllocatedBytes();
+
+ private:
+  SharedBufferArena() = default;
+
+  struct Buffer {
+    std::unique_ptr<uint8_t[]> data;
+    int64_t size = 0;
+    int64_t references = 0;
+  };
+
+  std::mutex mutex_;
+  std::map<int64_t, Buffer> buffers_;
+  int64_t next_id_ = 1;
+  int64_t allocated_bytes_ = 0;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_SHARED_BUFFER_ARENA_H_
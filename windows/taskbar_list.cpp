@@ -0,0 +1,47 @@
+#include "taskbar_list.h"
+
+#include <chrono>
+
+namespace window_manager_plus {
+
+// static
+TaskbarList& TaskbarList::GetInstance() {
+  static TaskbarList instance;
+  return instance;
+}
+
+void TaskbarList::AddRef() {
+  references_++;
+}
+
+void TaskbarList::Release() {
+  if (references_ > 0 && --references_ == 0 && taskbar_ != nullptr) {
+    taskbar_->Release();
+    taskbar_ = nullptr;
+  }
+}
+
+ITaskbarList3* TaskbarList::Get() {
+  if (taskbar_ != nullptr || is_unavailable_)
+    return taskbar_;
+
+  auto start = std::chrono::steady_clock::now();
+  HRESULT hr = ::CoCreateInstance(CLSID_TaskbarList, nullptr,
+                                  CLSCTX_INPROC_SERVER,
+                                  IID_PPV_ARGS(&taskbar_));
+  if (SUCCEEDED(hr)) {
+    hr = taskbar_->HrInit();
+    if (FAILED(hr)) {
+      taskbar_->Release();
+      taskbar_ = nullptr;
+    }
+  }
+  is_unavailable_ = FAILED(hr);
+  creation_ms_ += std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  creation_count_++;
+  return taskbar_;
+}
+
+}  // namespace window_manager_plus
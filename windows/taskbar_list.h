@@ -0,0 +1,56 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_TASKBAR_LIST_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_TASKBAR_LIST_H_
+
+#include <windows.h>
+
+#include <shobjidl_core.h>
+
+#include <cstdint>
+
+namespace window_manager_plus {
+
+// The ITaskbarList3 shared by every window of the process.
+//
+// Each window manager used to CoCreateInstance its own taskbar list in
+// WaitUntilReadyToShow, on the way to showing the window, and never
+// released it. The shared one is only created and HrInit'ed when a window
+// first needs it, and released when the last window that holds a
+// reference goes away. It is only used from the platform thread, where the
+// COM apartment of the windows lives.
+class TaskbarList {
+ public:
+  static TaskbarList& GetInstance();
+
+  // Taken by every window manager for as long as it lives.
+  void AddRef();
+  void Release();
+
+  // Returns the taskbar list, creating it on first use. Null if it could
+  // not be created, callers skip the taskbar then.
+  ITaskbarList3* Get();
+
+  // Lets the next Get try to create the taskbar list again after a failure,
+  // which can be transient, e.g. before Explorer is up. Called when a
+  // taskbar button is created.
+  void Retry() { is_unavailable_ = false; }
+
+  // How long creating and initializing the taskbar list took, in
+  // milliseconds, summed over every time it was created.
+  double GetCreationMilliseconds() const { return creation_ms_; }
+  int64_t GetCreationCount() const { return creation_count_; }
+
+ private:
+  TaskbarList() = default;
+
+  int64_t references_ = 0;
+  ITaskbarList3* taskbar_ = nullptr;
+  // Set when creation failed, so it is not retried on every call, only
+  // after Retry.
+  bool is_unavailable_ = false;
+  double creation_ms_ = 0;
+  int64_t creation_count_ = 0;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_TASKBAR_LIST_H_
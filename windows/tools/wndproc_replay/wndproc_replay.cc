@@ -0,0 +1,493 @@
+// Replays a trace of the window messages HandleWindowProc turns into window
+// state and channel events, through the same window_proc_core.h functions,
+// on any platform. Checks the "expect" lines of the trace against the
+// replayed state and prints the latency of each message kind and the number
+// of channel events the plugin would have emitted.
+//
+// Usage: wndproc_replay <trace> [--iterations N]
+//
+// Trace lines, '#' starts a comment:
+//   set interval <ms>             event coalescing interval, 0 disables it
+//   set aspect_ratio <ratio>      0 disables it
+//   set limits <min w> <min h> <max w> <max h> <pixel ratio>
+//   set work_area <l> <t> <r> <b>
+//   set full_screen <0|1>
+//   set frame <normal|frameless|hidden|frameless+hidden>
+//                                 is_frameless_ and the title bar style
+//   set windows_11 <0|1>
+//   <ms> WM_MOVING
+//   <ms> WM_SIZING <edge> <l> <t> <r> <b>
+//   <ms> WM_SIZE <restored|minimized|maximized|other>
+//   <ms> WM_GETMINMAXINFO <min x> <min y> <max x> <max y>
+//   <ms> WM_NCCALCSIZE <l> <t> <r> <b>
+//   <ms> WM_NCACTIVATE <0|1>
+//   <ms> WM_EXITSIZEMOVE
+//   expect rect <l> <t> <r> <b>   rect after the last WM_SIZING/NCCALCSIZE
+//   expect track <min x> <min y> <max x> <max y>
+//   expect state <last_state>
+//   expect frame_action <default|zero|work_area|hidden_title_bar|one>
+//                                 of the last WM_NCCALCSIZE/NCACTIVATE
+//   expect events <name>=<count> ...  events emitted since the start
+//   expect refreshes <count>      ForceChildRefresh calls since the start
+//
+// The window starts out frameless on Windows 11, so WM_NCCALCSIZE insets a
+// maximized or full screen window to the work area. From a maximizing
+// WM_SIZE to the next WM_SIZE the window counts as maximized, full screen
+// included, as GetWindowPlacement reports it. The coalescing timer fires at
+// the message times of the trace, like WM_TIMER would between them. A message's
+// latency includes the timer messages due before it and two clock reads.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "window_proc_core.h"
+
+namespace {
+
+using namespace window_manager_plus;
+
+struct Line {
+  int number;
+  std::string text;
+};
+
+// The parts of WindowManagerPlus that HandleWindowProc reads and writes for
+// the replayed messages.
+struct ReplayWindow {
+  int last_state = STATE_NORMAL;
+  bool is_full_screen = false;
+  bool is_maximized = false;
+  uint8_t frame_mode = kFrameModeFrameless;
+  bool is_windows_11 = true;
+  bool is_moving = false;
+  bool is_resizing = false;
+  double aspect_ratio = 0;
+  ProcPoint min_track_size_limit = {0, 0};
+  ProcPoint max_track_size_limit = {-1, -1};
+  ProcRect work_area = {0, 0, 1920, 1040};
+  uint32_t event_coalescing_interval = 16;
+  bool is_move_event_pending = false;
+  bool is_resize_event_pending = false;
+  bool is_event_coalescing_timer_set = false;
+  int64_t next_timer_ms = 0;
+
+  ProcRect rect = {0, 0, 0, 0};
+  FrameAction frame_action = FrameAction::kDefault;
+  ProcPoint min_track_size = {0, 0};
+  ProcPoint max_track_size = {0, 0};
+  std::map<std::string, int> events;
+  int refreshes = 0;
+
+  void Emit(const char* event) { events[event]++; }
+
+  // _FlushCoalescedEvents.
+  void FlushCoalescedEvents() {
+    if (is_move_event_pending) {
+      is_move_event_pending = false;
+      Emit("move");
+    }
+    if (is_resize_event_pending) {
+      is_resize_event_pending = false;
+      Emit("resize");
+    }
+  }
+
+  // _QueueCoalescedEvent.
+  void QueueCoalescedEvent(int64_t now_ms, bool is_resize) {
+    bool& pending = is_resize ? is_resize_event_pending : is_move_event_pending;
+    if (event_coalescing_interval == 0) {
+      Emit(is_resize ? "resize" : "move");
+      return;
+    }
+    if (pending) {
+      return;
+    }
+    pending = true;
+    if (!is_event_coalescing_timer_set) {
+      FlushCoalescedEvents();
+      is_event_coalescing_timer_set = true;
+      next_timer_ms = now_ms + event_coalescing_interval;
+    }
+  }
+
+  // Delivers the WM_TIMER messages due by |now_ms|.
+  void RunTimers(int64_t now_ms) {
+    while (is_event_coalescing_timer_set && next_timer_ms <= now_ms) {
+      if (!is_move_event_pending && !is_resize_event_pending) {
+        is_event_coalescing_timer_set = false;
+      }
+      FlushCoalescedEvents();
+      next_timer_ms += event_coalescing_interval;
+    }
+  }
+};
+
+struct MessageStats {
+  std::vector<double> latencies_ns;
+};
+
+bool Fail(const Line& line, const std::string& message) {
+  fprintf(stderr, "line %d: %s: %s\n", line.number, line.text.c_str(),
+          message.c_str());
+  return false;
+}
+
+const char* FrameActionName(FrameAction action) {
+  switch (action) {
+    case FrameAction::kDefault:
+      return "default";
+    case FrameAction::kReturnZero:
+      return "zero";
+    case FrameAction::kInsetToWorkArea:
+      return "work_area";
+    case FrameAction::kHideTitleBar:
+      return "hidden_title_bar";
+    case FrameAction::kReturnOne:
+      return "one";
+  }
+  return "?";
+}
+
+std::string RectString(const ProcRect& rect) {
+  return std::to_string(rect.left) + " " + std::to_string(rect.top) + " " +
+         std::to_string(rect.right) + " " + std::to_string(rect.bottom);
+}
+
+// A message line of the trace, parsed before the replay so parsing is not
+// part of the measured latency.
+struct TraceMessage {
+  std::string name;
+  int64_t time_ms = 0;
+  int32_t edge = 0;
+  bool wparam = false;
+  SizeKind size_kind = SizeKind::kOther;
+  ProcRect rect = {0, 0, 0, 0};
+};
+
+// Parses the arguments of |message|. Returns false on a malformed line.
+bool ParseMessage(std::istringstream& args, TraceMessage* message) {
+  ProcRect& rect = message->rect;
+  if (message->name == "WM_MOVING" || message->name == "WM_EXITSIZEMOVE") {
+    return true;
+  } else if (message->name == "WM_SIZING") {
+    return static_cast<bool>(args >> message->edge >> rect.left >> rect.top >>
+                             rect.right >> rect.bottom);
+  } else if (message->name == "WM_SIZE") {
+    std::string kind;
+    args >> kind;
+    message->size_kind = kind == "maximized"   ? SizeKind::kMaximized
+                         : kind == "minimized" ? SizeKind::kMinimized
+                         : kind == "restored"  ? SizeKind::kRestored
+                                               : SizeKind::kOther;
+    return true;
+  } else if (message->name == "WM_NCACTIVATE") {
+    int wparam = 0;
+    bool parsed = static_cast<bool>(args >> wparam);
+    message->wparam = wparam != 0;
+    return parsed;
+  } else if (message->name == "WM_GETMINMAXINFO" ||
+             message->name == "WM_NCCALCSIZE") {
+    // WM_GETMINMAXINFO carries the default min and max track sizes.
+    return static_cast<bool>(args >> rect.left >> rect.top >> rect.right >>
+                             rect.bottom);
+  }
+  return false;
+}
+
+// Runs |message| through |window| like HandleWindowProc would.
+void HandleMessage(ReplayWindow* window, const TraceMessage& message) {
+  const std::string& name = message.name;
+  if (name == "WM_MOVING") {
+    window->is_moving = true;
+    window->QueueCoalescedEvent(message.time_ms, false);
+  } else if (name == "WM_SIZING") {
+    window->is_resizing = true;
+    window->QueueCoalescedEvent(message.time_ms, true);
+    ProcRect rect = message.rect;
+    if (window->aspect_ratio > 0) {
+      ApplyAspectRatio(window->aspect_ratio, message.edge, &rect);
+    }
+    window->rect = rect;
+  } else if (name == "WM_SIZE") {
+    SizeTransition transition = NextSizeState(
+        window->last_state, window->is_full_screen, message.size_kind);
+    window->is_maximized = message.size_kind == SizeKind::kMaximized;
+    if (transition.event != nullptr) {
+      if (transition.refresh_children) {
+        window->refreshes++;
+      }
+      window->Emit(transition.event);
+      window->last_state = transition.state;
+    }
+  } else if (name == "WM_GETMINMAXINFO") {
+    window->min_track_size = {message.rect.left, message.rect.top};
+    window->max_track_size = {message.rect.right, message.rect.bottom};
+    ApplyTrackSizeLimits(window->min_track_size_limit,
+                         window->max_track_size_limit, &window->min_track_size,
+                         &window->max_track_size);
+  } else if (name == "WM_NCCALCSIZE") {
+    ProcRect rect = message.rect;
+    window->frame_action =
+        NcCalcSizeAction(window->frame_mode, window->is_full_screen,
+                         window->frame_mode != 0 && window->is_maximized);
+    if (window->frame_action == FrameAction::kInsetToWorkArea) {
+      InsetToWorkArea(window->work_area, &rect);
+    } else if (window->frame_action == FrameAction::kHideTitleBar) {
+      InsetForHiddenTitleBar(window->is_windows_11, &rect);
+    }
+    window->rect = rect;
+  } else if (name == "WM_NCACTIVATE") {
+    window->Emit(message.wparam ? "focus" : "blur");
+    window->frame_action = NcActivateAction(window->frame_mode);
+  } else if (name == "WM_EXITSIZEMOVE") {
+    window->FlushCoalescedEvents();
+    window->is_event_coalescing_timer_set = false;
+    if (window->is_resizing) {
+      window->Emit("resized");
+      window->is_resizing = false;
+    }
+    if (window->is_moving) {
+      window->Emit("moved");
+      window->is_moving = false;
+    }
+  }
+}
+
+bool HandleSet(ReplayWindow* window, std::istringstream& args) {
+  std::string name;
+  args >> name;
+  if (name == "interval") {
+    return static_cast<bool>(args >> window->event_coalescing_interval);
+  } else if (name == "aspect_ratio") {
+    return static_cast<bool>(args >> window->aspect_ratio);
+  } else if (name == "limits") {
+    ProcPoint min_size, max_size;
+    double pixel_ratio = 1;
+    if (!(args >> min_size.x >> min_size.y >> max_size.x >> max_size.y >>
+          pixel_ratio))
+      return false;
+    window->min_track_size_limit =
+        ScaleTrackSizeLimit(min_size, 0, pixel_ratio);
+    window->max_track_size_limit =
+        ScaleTrackSizeLimit(max_size, -1, pixel_ratio);
+    return true;
+  } else if (name == "work_area") {
+    ProcRect& area = window->work_area;
+    return static_cast<bool>(args >> area.left >> area.top >> area.right >>
+                             area.bottom);
+  } else if (name == "full_screen") {
+    int value = 0;
+    args >> value;
+    window->is_full_screen = value != 0;
+    return true;
+  } else if (name == "frame") {
+    std::string frame;
+    args >> frame;
+    window->frame_mode = 0;
+    if (frame == "frameless" || frame == "frameless+hidden")
+      window->frame_mode |= kFrameModeFrameless;
+    if (frame == "hidden" || frame == "frameless+hidden")
+      window->frame_mode |= kFrameModeHiddenTitleBar;
+    return window->frame_mode != 0 || frame == "normal";
+  } else if (name == "windows_11") {
+    int value = 1;
+    args >> value;
+    window->is_windows_11 = value != 0;
+    return true;
+  }
+  return false;
+}
+
+bool CheckExpect(const ReplayWindow& window,
+                 const Line& line,
+                 std::istringstream& args) {
+  std::string what;
+  args >> what;
+  if (what == "rect") {
+    ProcRect rect;
+    args >> rect.left >> rect.top >> rect.right >> rect.bottom;
+    if (RectString(rect) != RectString(window.rect)) {
+      return Fail(line, "rect is " + RectString(window.rect));
+    }
+  } else if (what == "track") {
+    ProcRect track;
+    args >> track.left >> track.top >> track.right >> track.bottom;
+    ProcRect actual = {window.min_track_size.x, window.min_track_size.y,
+                       window.max_track_size.x, window.max_track_size.y};
+    if (RectString(track) != RectString(actual)) {
+      return Fail(line, "track sizes are " + RectString(actual));
+    }
+  } else if (what == "state") {
+    int state = -1;
+    args >> state;
+    if (state != window.last_state) {
+      return Fail(line, "state is " + std::to_string(window.last_state));
+    }
+  } else if (what == "frame_action") {
+    std::string action;
+    args >> action;
+    if (action != FrameActionName(window.frame_action)) {
+      return Fail(line, std::string("frame action is ") +
+                            FrameActionName(window.frame_action));
+    }
+  } else if (what == "events") {
+    std::string pair;
+    while (args >> pair) {
+      size_t equals = pair.find('=');
+      std::string name = pair.substr(0, equals);
+      int count = atoi(pair.c_str() + equals + 1);
+      auto it = window.events.find(name);
+      int actual = it != window.events.end() ? it->second : 0;
+      if (actual != count) {
+        return Fail(line, name + " was emitted " + std::to_string(actual) +
+                              " times");
+      }
+    }
+  } else if (what == "refreshes") {
+    int count = -1;
+    args >> count;
+    if (count != window.refreshes) {
+      return Fail(line, "refreshed " + std::to_string(window.refreshes) +
+                            " times");
+    }
+  } else {
+    return Fail(line, "unknown expectation");
+  }
+  return true;
+}
+
+// A line of the trace: a setting or expectation kept as text, or a parsed
+// message.
+struct Step {
+  Line line;
+  bool is_message;
+  TraceMessage message;
+};
+
+bool ParseTrace(const std::vector<Line>& lines, std::vector<Step>* steps) {
+  for (const Line& line : lines) {
+    std::istringstream fields(line.text);
+    std::string first;
+    fields >> first;
+    Step step = {line, false, {}};
+    if (first != "set" && first != "expect") {
+      step.is_message = true;
+      step.message.time_ms = strtoll(first.c_str(), nullptr, 10);
+      fields >> step.message.name;
+      if (!ParseMessage(fields, &step.message)) {
+        return Fail(line, "malformed message");
+      }
+    }
+    steps->push_back(step);
+  }
+  return true;
+}
+
+// Replays |steps| once. Expectations are only checked when |check| is set,
+// so they don't show up in the timed replays.
+bool Replay(const std::vector<Step>& steps,
+            bool check,
+            std::map<std::string, MessageStats>* stats,
+            ReplayWindow* window) {
+  for (const Step& step : steps) {
+    if (step.is_message) {
+      auto start = std::chrono::steady_clock::now();
+      window->RunTimers(step.message.time_ms);
+      HandleMessage(window, step.message);
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      (*stats)[step.message.name].latencies_ns.push_back(
+          std::chrono::duration<double, std::nano>(elapsed).count());
+      continue;
+    }
+    std::istringstream fields(step.line.text);
+    std::string first;
+    fields >> first;
+    if (first == "set") {
+      if (!HandleSet(window, fields)) {
+        return Fail(step.line, "malformed setting");
+      }
+    } else if (check && !CheckExpect(*window, step.line, fields)) {
+      return false;
+    }
+  }
+  window->RunTimers(INT64_MAX);
+  return true;
+}
+
+double Percentile(std::vector<double>* values, double fraction) {
+  size_t index = static_cast<size_t>(fraction * (values->size() - 1));
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <trace> [--iterations N]\n", argv[0]);
+    return 2;
+  }
+  int64_t iterations = 1000;
+  for (int i = 2; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0) {
+      iterations = std::max<int64_t>(1, strtoll(argv[i + 1], nullptr, 10));
+    }
+  }
+
+  std::ifstream file(argv[1]);
+  if (!file) {
+    fprintf(stderr, "can't read trace %s\n", argv[1]);
+    return 2;
+  }
+  std::vector<Line> lines;
+  std::string text;
+  for (int number = 1; std::getline(file, text); number++) {
+    text = text.substr(0, text.find('#'));
+    if (text.find_first_not_of(" \t\r") != std::string::npos) {
+      lines.push_back({number, text});
+    }
+  }
+
+  std::vector<Step> steps;
+  if (!ParseTrace(lines, &steps)) {
+    return 1;
+  }
+  std::map<std::string, MessageStats> stats;
+  ReplayWindow checked;
+  if (!Replay(steps, true, &stats, &checked)) {
+    return 1;
+  }
+  for (int64_t i = 1; i < iterations; i++) {
+    ReplayWindow window;
+    Replay(steps, false, &stats, &window);
+  }
+
+  printf("%-18s %8s %10s %10s %10s\n", "message", "count", "mean ns",
+         "p50 ns", "p99 ns");
+  for (auto& [message, message_stats] : stats) {
+    std::vector<double>& latencies = message_stats.latencies_ns;
+    double total = 0;
+    for (double latency : latencies) {
+      total += latency;
+    }
+    printf("%-18s %8zu %10.1f %10.1f %10.1f\n", message.c_str(),
+           latencies.size() / static_cast<size_t>(iterations),
+           total / latencies.size(), Percentile(&latencies, 0.5),
+           Percentile(&latencies, 0.99));
+  }
+  printf("\nchannel events per replay:\n");
+  for (const auto& [event, count] : checked.events) {
+    printf("  %-18s %d\n", event.c_str(), count);
+  }
+  printf("  %-18s %d\n", "(refreshes)", checked.refreshes);
+  return 0;
+}
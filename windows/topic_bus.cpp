@@ -0,0 +1,135 @@
+#include "topic_bus.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "window_manager_plus.h"
+
+namespace window_manager_plus {
+
+// static
+TopicBus& TopicBus::GetInstance() {
+  static TopicBus instance;
+  return instance;
+}
+
+void TopicBus::Subscribe(const std::string& topic, int64_t window_id) {
+  auto& subscribers = topics_[topic].subscribers;
+  if (std::find(subscribers.begin(), subscribers.end(), window_id) ==
+      subscribers.end()) {
+    subscribers.push_back(window_id);
+  }
+}
+
+void TopicBus::Unsubscribe(const std::string& topic, int64_t window_id) {
+  auto it = topics_.find(topic);
+  if (it == topics_.end())
+    return;
+  auto& subscribers = it->second.subscribers;
+  subscribers.erase(
+      std::remove(subscribers.begin(), subscribers.end(), window_id),
+      subscribers.end());
+}
+
+void TopicBus::UnsubscribeAll(int64_t window_id) {
+  for (auto& [name, topic] : topics_) {
+    auto& subscribers = topic.subscribers;
+    subscribers.erase(
+        std::remove(subscribers.begin(), subscribers.end(), window_id),
+        subscribers.end());
+  }
+}
+
+void TopicBus::SetCoalesceInterval(const std::string& topic, UINT interval) {
+  topics_[topic].coalesce_interval = interval;
+}
+
+size_t TopicBus::Publish(const std::string& name,
+                         int64_t from_window_id,
+                         flutter::EncodableValue value) {
+  Topic& topic = topics_[name];
+  topic.published++;
+  if (topic.coalesce_interval == 0) {
+    Deliver(name, topic, from_window_id, value);
+    return topic.subscribers.size();
+  }
+
+  if (topic.has_pending) {
+    topic.coalesced++;
+  }
+  topic.has_pending = true;
+  topic.pending_from_window_id = from_window_id;
+  topic.pending_value = std::move(value);
+  if (topic.flush_timer == 0) {
+    topic.flush_timer =
+        SetTimer(nullptr, 0, topic.coalesce_interval, FlushTopic);
+    flush_timers_[topic.flush_timer] = name;
+  }
+  return topic.subscribers.size();
+}
+
+void TopicBus::Deliver(const std::string& name,
+                       Topic& topic,
+                       int64_t from_window_id,
+                       const flutter::EncodableValue& value) {
+  // Built once, each channel still encodes its own copy.
+  flutter::EncodableMap message = {
+      {flutter::EncodableValue("eventName"),
+       flutter::EncodableValue("topic-message")},
+      {flutter::EncodableValue("topic"), flutter::EncodableValue(name)},
+      {flutter::EncodableValue("fromWindowId"),
+       flutter::EncodableValue(from_window_id)},
+      {flutter::EncodableValue("value"), value}};
+  for (int64_t window_id : topic.subscribers) {
+    auto manager = WindowManagerPlus::registry_.FindManager(window_id);
+    if (!manager || !manager->channel)
+      continue;
+    manager->channel->InvokeMethod(
+        "onEvent", std::make_unique<flutter::EncodableValue>(message));
+    topic.delivered++;
+  }
+}
+
+// static
+void CALLBACK TopicBus::FlushTopic(HWND hwnd,
+                                   UINT message,
+                                   UINT_PTR timer_id,
+                                   DWORD time) {
+  KillTimer(nullptr, timer_id);
+  TopicBus& bus = GetInstance();
+  auto it = bus.flush_timers_.find(timer_id);
+  if (it == bus.flush_timers_.end())
+    return;
+  std::string name = std::move(it->second);
+  bus.flush_timers_.erase(it);
+
+  Topic& topic = bus.topics_[name];
+  topic.flush_timer = 0;
+  if (!topic.has_pending)
+    return;
+  topic.has_pending = false;
+  flutter::EncodableValue value = std::move(topic.pending_value);
+  topic.pending_value = flutter::EncodableValue();
+  bus.Deliver(name, topic, topic.pending_from_window_id, value);
+}
+
+flutter::EncodableMap TopicBus::GetMetrics() {
+  flutter::EncodableMap metrics = flutter::EncodableMap();
+  for (const auto& [name, topic] : topics_) {
+    metrics[flutter::EncodableValue(name)] =
+        flutter::EncodableValue(flutter::EncodableMap{
+            {flutter::EncodableValue("subscribers"),
+             flutter::EncodableValue(
+                 static_cast<int64_t>(topic.subscribers.size()))},
+            {flutter::EncodableValue("published"),
+             flutter::EncodableValue(topic.published)},
+            {flutter::EncodableValue("delivered"),
+             flutter::EncodableValue(topic.delivered)},
+            {flutter::EncodableValue("coalesced"),
+             flutter::EncodableValue(topic.coalesced)},
+        });
+  }
+  return metrics;
+}
+
+}  // namespace window_manager_plus
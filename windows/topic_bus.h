@@ -0,0 +1,76 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_TOPIC_BUS_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_TOPIC_BUS_H_
+
+#include <windows.h>
+
+#include <flutter/encodable_value.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace window_manager_plus {
+
+// Publish/subscribe between windows.
+//
+// A publish is delivered by the native side to the channel of every window
+// subscribed to its topic, so a window fans a message out with one method
+// call instead of one invokeMethodToWindow round trip per window. Like the
+// window registry, the bus is only touched from the platform thread.
+class TopicBus {
+ public:
+  static TopicBus& GetInstance();
+
+  void Subscribe(const std::string& topic, int64_t window_id);
+
+  void Unsubscribe(const std::string& topic, int64_t window_id);
+
+  // Removes |window_id| from every topic, when its window is closed.
+  void UnsubscribeAll(int64_t window_id);
+
+  // Holds the publishes to |topic| for |interval| milliseconds and only
+  // delivers the latest one. 0 delivers every publish right away.
+  void SetCoalesceInterval(const std::string& topic, UINT interval);
+
+  // Returns the number of windows |value| is delivered to, now or at the end
+  // of the topic's coalescing interval.
+  size_t Publish(const std::string& topic,
+                 int64_t from_window_id,
+                 flutter::EncodableValue value);
+
+  // Subscriber count and delivery counters of every topic, by topic name.
+  flutter::EncodableMap GetMetrics();
+
+ private:
+  struct Topic {
+    std::vector<int64_t> subscribers;
+    UINT coalesce_interval = 0;
+    UINT_PTR flush_timer = 0;
+    bool has_pending = false;
+    int64_t pending_from_window_id = 0;
+    flutter::EncodableValue pending_value;
+    int64_t published = 0;
+    int64_t delivered = 0;
+    int64_t coalesced = 0;
+  };
+
+  TopicBus() = default;
+
+  void Deliver(const std::string& name,
+               Topic& topic,
+               int64_t from_window_id,
+               const flutter::EncodableValue& value);
+
+  static void CALLBACK FlushTopic(HWND hwnd,
+                                  UINT message,
+                                  UINT_PTR timer_id,
+                                  DWORD time);
+
+  std::map<std::string, Topic> topics_;
+  // Topic of every running coalescing timer.
+  std::map<UINT_PTR, std::string> flush_timers_;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_TOPIC_BUS_H_
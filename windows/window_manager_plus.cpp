@@ -13,9 +13,17 @@
 #include <memory>
 #include <sstream>
 
+#include "dynamic_api.h"
+#include "icon_cache.h"
+#include "monitor_cache.h"
+#include "shared_buffer_arena.h"
+#include "taskbar_list.h"
 #include "window_manager_plus.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 
 #pragma comment(lib, "dwmapi.lib")
 #pragma comment(lib, "user32.lib")
@@ -45,6 +53,13 @@ constexpr const wchar_t kGetPreferredBrightnessRegValue[] =
 
 #define APPBAR_CALLBACK WM_USER + 0x01;
 
+constexpr const wchar_t kWindowReleaseClassName[] =
+    L"WINDOW_MANAGER_PLUS_WINDOW_RELEASE";
+
+// Posted to WindowManagerPlus::window_release_hwnd_ to release the queued
+// windows.
+constexpr UINT kReleaseWindowsMessage = WM_APP + 0x01;
+
 namespace window_manager_plus {
 
 WindowManagerPlusPluginWindowCreatedCallback g_window_created_callback =
@@ -59,9 +74,80 @@ const flutter::EncodableValue* ValueOrNull(const flutter::EncodableMap& map,
   return &(it->second);
 }
 
-WindowManagerPlus::WindowManagerPlus() {}
+// Converts a UTF-16 string from a Win32 API to UTF-8.
+std::string Utf8FromWide(const std::wstring& value) {
+  if (value.empty()) {
+    return std::string();
+  }
+  int length = WideCharToMultiByte(CP_UTF8, 0, value.data(),
+                                   static_cast<int>(value.size()), nullptr, 0,
+                                   nullptr, nullptr);
+  std::string utf8(length > 0 ? length : 0, '\0');
+  if (length > 0) {
+    WideCharToMultiByte(CP_UTF8, 0, value.data(),
+                        static_cast<int>(value.size()), utf8.data(), length,
+                        nullptr, nullptr);
+  }
+  return utf8;
+}
+
+// Returns the refresh interval of the monitor showing |hwnd|, in milliseconds.
+UINT GetRefreshInterval(HWND hwnd) {
+  UINT refresh_rate = MonitorCache::GetInstance().FromWindow(hwnd).refresh_rate;
+  return refresh_rate > 0 ? 1000 / refresh_rate : 16;
+}
+
+// Resizes |hWnd| by one pixel and back, for RefreshMode::kNudge. Each of
+// the two resizes goes through WM_NCCALCSIZE and WM_SIZE.
+void NudgeWindowSize(HWND hWnd) {
+  RECT rect;
+
+  GetWindowRect(hWnd, &rect);
+  SetWindowPos(
+      hWnd, nullptr, rect.left, rect.top, rect.right - rect.left + 1,
+      rect.bottom - rect.top,
+      SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_FRAMECHANGED);
+  SetWindowPos(
+      hWnd, nullptr, rect.left, rect.top, rect.right - rect.left,
+      rect.bottom - rect.top,
+      SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_FRAMECHANGED);
+}
+
+bool IsSameSize(const RECT& a, const RECT& b) {
+  return a.right - a.left == b.right - b.left &&
+         a.bottom - a.top == b.bottom - b.top;
+}
+
+// Maps the linear progress |t| of a bounds animation onto |curve|.
+double EaseBoundsAnimation(const std::string& curve, double t) {
+  if (curve == "linear") {
+    return t;
+  }
+  if (curve == "easeIn") {
+    return t * t * t;
+  }
+  if (curve == "easeOut") {
+    return 1 - std::pow(1 - t, 3);
+  }
+  return t < 0.5 ? 4 * t * t * t : 1 - std::pow(-2 * t + 2, 3) / 2;
+}
+
+WindowManagerPlus::WindowManagerPlus() {
+  TaskbarList::GetInstance().AddRef();
+}
 
 WindowManagerPlus::~WindowManagerPlus() {
+  if (event_ring_ != nullptr) {
+    std::lock_guard<std::mutex> lock(event_rings_mutex_);
+    auto it = event_rings_.find(id);
+    if (it != event_rings_.end() && it->second == event_ring_)
+      event_rings_.erase(it);
+  }
+  TaskbarList::GetInstance().Release();
+  if (!icon_key_.empty())
+    IconCache::GetInstance().Release(icon_key_);
+  if (!pending_icon_key_.empty())
+    IconCache::GetInstance().Release(pending_icon_key_);
 #ifndef NDEBUG
   std::cout << "WindowManager dealloc" << std::endl;
 #endif
@@ -69,59 +155,389 @@ WindowManagerPlus::~WindowManagerPlus() {
 
 int64_t WindowManagerPlus::createWindow(const std::vector<std::string>& args) {
   if (g_window_created_callback) {
-    WindowManagerPlus::autoincrementId_++;
-    auto windowId = WindowManagerPlus::autoincrementId_;
+    auto windowId = WindowManagerPlus::registry_.Add();
+    if (windowId < 0) {
+      return -1;
+    }
     std::vector<std::string> v1 = {std::to_string(windowId)};
 
     // add the windowId as first argument to command_line_arguments
     std::vector<std::string> dst;
     std::merge(v1.begin(), v1.end(), args.begin(), args.end(),
                std::back_inserter(dst));
-    auto fWindow = g_window_created_callback(std::move(dst));
-    WindowManagerPlus::windows_.insert({windowId, std::move(fWindow)});
+
+    // Hand out a pooled window whose Dart side is already waiting for its
+    // arguments, and only start a new engine if there is none.
+    auto pooled = std::find_if(window_pool_.begin(), window_pool_.end(),
+                               [](const PooledWindow& window) {
+                                 return window.assignment != nullptr;
+                               });
+    bool from_pool = pooled != window_pool_.end();
+    if (from_pool) {
+      window_pool_hits_++;
+      flutter::EncodableList arguments;
+      for (const auto& arg : dst) {
+        arguments.push_back(flutter::EncodableValue(arg));
+      }
+      pooled->assignment->Success(flutter::EncodableValue(arguments));
+      WindowManagerPlus::registry_.SetWindow(windowId,
+                                             std::move(pooled->window));
+      window_pool_.erase(pooled);
+      ScheduleWindowPoolRefill();
+    } else {
+      if (window_pool_size_ > 0) {
+        window_pool_misses_++;
+      }
+      auto fWindow = g_window_created_callback(std::move(dst));
+      WindowManagerPlus::registry_.SetWindow(windowId, std::move(fWindow));
+    }
+    pending_first_frames_[windowId] = {std::chrono::steady_clock::now(),
+                                       from_pool};
     return windowId;
   }
   return -1;
 }
 
+void CALLBACK RefillWindowPool(HWND hwnd,
+                               UINT message,
+                               UINT_PTR timer_id,
+                               DWORD time) {
+  KillTimer(nullptr, timer_id);
+  WindowManagerPlus::window_pool_refill_timer_ = 0;
+  if (!g_window_created_callback ||
+      WindowManagerPlus::window_pool_.size() >=
+          WindowManagerPlus::window_pool_size_) {
+    return;
+  }
+
+  PooledWindow pooled;
+  pooled.token = ++WindowManagerPlus::window_pool_token_;
+  pooled.window = g_window_created_callback(
+      {POOLED_WINDOW_ARGUMENT, std::to_string(pooled.token)});
+  WindowManagerPlus::window_pool_.push_back(std::move(pooled));
+
+  // One engine per message loop turn keeps input and painting responsive
+  // while the pool fills up.
+  WindowManagerPlus::ScheduleWindowPoolRefill();
+}
+
+void WindowManagerPlus::ScheduleWindowPoolRefill() {
+  if (window_pool_refill_timer_ != 0 ||
+      window_pool_.size() >= window_pool_size_) {
+    return;
+  }
+  window_pool_refill_timer_ = SetTimer(nullptr, 0, 0, RefillWindowPool);
+}
+
+void WindowManagerPlus::SetWindowPoolSize(const flutter::EncodableMap& args) {
+  int size = std::get<int>(args.at(flutter::EncodableValue("size")));
+  window_pool_size_ = size > 0 ? static_cast<size_t>(size) : 0;
+
+  while (window_pool_.size() > window_pool_size_) {
+    PooledWindow& pooled = window_pool_.back();
+    if (pooled.assignment) {
+      pooled.assignment->Error("0", "The window pool has been shrunk");
+    }
+    pooled.window->Destroy();
+    QueueWindowRelease(std::move(pooled.window));
+    window_pool_.pop_back();
+  }
+  ScheduleWindowPoolRefill();
+}
+
+void WindowManagerPlus::WaitForPooledWindow(
+    int64_t token,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  for (auto& pooled : window_pool_) {
+    if (pooled.token == token) {
+      pooled.assignment = std::move(result);
+      return;
+    }
+  }
+  result->Error("0", "The pooled window is no longer in the window pool");
+}
+
+void WindowManagerPlus::RecordFirstFrame(int64_t window_id) {
+  auto it = pending_first_frames_.find(window_id);
+  if (it == pending_first_frames_.end()) {
+    return;
+  }
+
+  auto elapsed = std::chrono::steady_clock::now() - it->second.created_at;
+  double elapsed_ms =
+      std::chrono::duration<double, std::milli>(elapsed).count();
+  if (it->second.from_pool) {
+    pooled_first_frame_ms_ += elapsed_ms;
+    pooled_first_frame_count_++;
+  } else {
+    unpooled_first_frame_ms_ += elapsed_ms;
+    unpooled_first_frame_count_++;
+  }
+  pending_first_frames_.erase(it);
+}
+
+LRESULT CALLBACK WindowReleaseProc(HWND hwnd,
+                                   UINT message,
+                                   WPARAM wparam,
+                                   LPARAM lparam) {
+  if (message == kReleaseWindowsMessage) {
+    WindowManagerPlus::ReleaseWindows();
+    return 0;
+  }
+  return DefWindowProc(hwnd, message, wparam, lparam);
+}
+
+void WindowManagerPlus::QueueWindowRelease(int64_t window_id) {
+  auto window = registry_.Remove(window_id);
+  if (window) {
+    QueueWindowRelease(std::move(window));
+  }
+}
+
+void WindowManagerPlus::QueueWindowRelease(
+    std::shared_ptr<FlutterWindow> window) {
+  if (window_release_hwnd_ == nullptr) {
+    WNDCLASS window_class{};
+    window_class.lpfnWndProc = WindowReleaseProc;
+    window_class.hInstance = GetModuleHandle(nullptr);
+    window_class.lpszClassName = kWindowReleaseClassName;
+    RegisterClass(&window_class);
+    window_release_hwnd_ =
+        CreateWindow(kWindowReleaseClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE,
+                     nullptr, GetModuleHandle(nullptr), nullptr);
+  }
+
+  // Windows closed while a release is pending are released in the same
+  // batch.
+  bool is_release_pending = !windows_to_release_.empty();
+  windows_to_release_.push_back(
+      {std::move(window), std::chrono::steady_clock::now()});
+  if (!is_release_pending && window_release_hwnd_ != nullptr) {
+    PostMessage(window_release_hwnd_, kReleaseWindowsMessage, 0, 0);
+  }
+}
+
+void WindowManagerPlus::ReleaseWindows() {
+  // Releasing a window can close others, so take the batch out first.
+  std::vector<ReleasedWindow> windows = std::move(windows_to_release_);
+  windows_to_release_.clear();
+
+  auto now = std::chrono::steady_clock::now();
+  for (const auto& released : windows) {
+    window_release_ms_ += std::chrono::duration<double, std::milli>(
+                              now - released.queued_at)
+                              .count();
+  }
+  released_window_count_ += windows.size();
+}
+
+flutter::EncodableMap WindowManagerPlus::GetWindowReleaseMetrics() {
+  flutter::EncodableMap metrics = flutter::EncodableMap();
+  metrics[flutter::EncodableValue("released")] =
+      flutter::EncodableValue(released_window_count_);
+  metrics[flutter::EncodableValue("pending")] = flutter::EncodableValue(
+      static_cast<int64_t>(windows_to_release_.size()));
+  metrics[flutter::EncodableValue("averageTimeToRelease")] =
+      flutter::EncodableValue(
+          released_window_count_ > 0
+              ? window_release_ms_ / released_window_count_
+              : 0.0);
+  return metrics;
+}
+
+flutter::EncodableList WindowManagerPlus::GetDisplays() {
+  POINT cursor = {};
+  bool hasCursor = GetCursorPos(&cursor);
+
+  flutter::EncodableList displays;
+  for (const auto& info : MonitorCache::GetInstance().GetMonitors()) {
+    // Like screen_retriever, report logical pixels of each display's own
+    // scale factor.
+    double scaleFactor = info.dpi / 96.0;
+    const RECT& bounds = info.monitor_rect;
+    const RECT& workArea = info.work_area;
+    flutter::EncodableMap display = flutter::EncodableMap();
+    display[flutter::EncodableValue("id")] =
+        flutter::EncodableValue(Utf8FromWide(info.device_name));
+    display[flutter::EncodableValue("x")] =
+        flutter::EncodableValue(bounds.left / scaleFactor);
+    display[flutter::EncodableValue("y")] =
+        flutter::EncodableValue(bounds.top / scaleFactor);
+    display[flutter::EncodableValue("width")] =
+        flutter::EncodableValue((bounds.right - bounds.left) / scaleFactor);
+    display[flutter::EncodableValue("height")] =
+        flutter::EncodableValue((bounds.bottom - bounds.top) / scaleFactor);
+    display[flutter::EncodableValue("visibleX")] =
+        flutter::EncodableValue(workArea.left / scaleFactor);
+    display[flutter::EncodableValue("visibleY")] =
+        flutter::EncodableValue(workArea.top / scaleFactor);
+    display[flutter::EncodableValue("visibleWidth")] = flutter::EncodableValue(
+        (workArea.right - workArea.left) / scaleFactor);
+    display[flutter::EncodableValue("visibleHeight")] = flutter::EncodableValue(
+        (workArea.bottom - workArea.top) / scaleFactor);
+    display[flutter::EncodableValue("scaleFactor")] =
+        flutter::EncodableValue(scaleFactor);
+    display[flutter::EncodableValue("refreshRate")] =
+        flutter::EncodableValue(static_cast<int>(info.refresh_rate));
+    display[flutter::EncodableValue("isPrimary")] =
+        flutter::EncodableValue(info.is_primary);
+    display[flutter::EncodableValue("hasCursor")] = flutter::EncodableValue(
+        hasCursor && PtInRect(&bounds, cursor) == TRUE);
+    displays.push_back(flutter::EncodableValue(display));
+  }
+  return displays;
+}
+
+flutter::EncodableMap WindowManagerPlus::GetWindowPoolMetrics() {
+  int64_t ready = std::count_if(
+      window_pool_.begin(), window_pool_.end(),
+      [](const PooledWindow& window) { return window.assignment != nullptr; });
+
+  flutter::EncodableMap metrics = flutter::EncodableMap();
+  metrics[flutter::EncodableValue("size")] =
+      flutter::EncodableValue(static_cast<int64_t>(window_pool_size_));
+  metrics[flutter::EncodableValue("ready")] = flutter::EncodableValue(ready);
+  metrics[flutter::EncodableValue("warming")] = flutter::EncodableValue(
+      static_cast<int64_t>(window_pool_.size()) - ready);
+  metrics[flutter::EncodableValue("hits")] =
+      flutter::EncodableValue(window_pool_hits_);
+  metrics[flutter::EncodableValue("misses")] =
+      flutter::EncodableValue(window_pool_misses_);
+  metrics[flutter::EncodableValue("pooledTimeToFirstFrame")] =
+      flutter::EncodableValue(
+          pooled_first_frame_count_ > 0
+              ? pooled_first_frame_ms_ / pooled_first_frame_count_
+              : 0.0);
+  metrics[flutter::EncodableValue("unpooledTimeToFirstFrame")] =
+      flutter::EncodableValue(
+          unpooled_first_frame_count_ > 0
+              ? unpooled_first_frame_ms_ / unpooled_first_frame_count_
+              : 0.0);
+  return metrics;
+}
+
+uint32_t WindowManagerPlus::GetWindowEventMask(std::string_view event_name) {
+  static constexpr std::string_view kWindowEvents[] = {
+      "initialized",
+      "close",
+      "focus",
+      "blur",
+      "maximize",
+      "unmaximize",
+      "minimize",
+      "restore",
+      "resize",
+      "resized",
+      "move",
+      "moved",
+      "enter-full-screen",
+      "leave-full-screen",
+      "show",
+      "hide",
+      "docked",
+      "undocked",
+  };
+  static_assert(std::size(kWindowEvents) <= 32,
+                "global_event_mask_ has room for 32 events");
+
+  for (size_t i = 0; i < std::size(kWindowEvents); i++) {
+    if (kWindowEvents[i] == event_name) {
+      return 1u << i;
+    }
+  }
+  return 0;
+}
+
 HWND WindowManagerPlus::GetMainWindow() {
   return native_window;
 }
 
 void WindowManagerPlus::ForceRefresh() {
   HWND hWnd = GetMainWindow();
+  HWND child = GetWindow(hWnd, GW_CHILD);
+  refresh_count_++;
 
-  RECT rect;
+  if (refresh_mode_ == RefreshMode::kNudge) {
+    NudgeWindowSize(hWnd);
+    if (child != nullptr)
+      refresh_surface_resize_count_ += 2;
+    return;
+  }
 
-  GetWindowRect(hWnd, &rect);
-  SetWindowPos(
-      hWnd, nullptr, rect.left, rect.top, rect.right - rect.left + 1,
-      rect.bottom - rect.top,
-      SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_FRAMECHANGED);
-  SetWindowPos(
-      hWnd, nullptr, rect.left, rect.top, rect.right - rect.left,
-      rect.bottom - rect.top,
-      SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_FRAMECHANGED);
+  // One WM_NCCALCSIZE recomputes the frame. Windows only follows it with
+  // WM_SIZE, which resizes the Flutter view, if the client area changed.
+  RECT before = {};
+  if (child != nullptr)
+    GetClientRect(child, &before);
+  SetWindowPos(hWnd, nullptr, 0, 0, 0, 0,
+               SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_NOSIZE |
+                   SWP_NOACTIVATE | SWP_FRAMECHANGED);
+  RECT after = {};
+  if (child != nullptr) {
+    GetClientRect(child, &after);
+    if (!IsSameSize(before, after))
+      refresh_surface_resize_count_++;
+  }
 }
 
 void WindowManagerPlus::ForceChildRefresh() {
-  HWND hWnd = GetWindow(GetMainWindow(), GW_CHILD);
+  HWND hWnd = GetMainWindow();
+  HWND child = GetWindow(hWnd, GW_CHILD);
+  if (child == nullptr)
+    return;
+  refresh_count_++;
 
-  RECT rect;
+  if (refresh_mode_ == RefreshMode::kNudge) {
+    NudgeWindowSize(child);
+    refresh_surface_resize_count_ += 2;
+    return;
+  }
 
-  GetWindowRect(hWnd, &rect);
-  SetWindowPos(
-      hWnd, nullptr, rect.left, rect.top, rect.right - rect.left + 1,
-      rect.bottom - rect.top,
-      SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_FRAMECHANGED);
-  SetWindowPos(
-      hWnd, nullptr, rect.left, rect.top, rect.right - rect.left,
-      rect.bottom - rect.top,
-      SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE | SWP_FRAMECHANGED);
+  RECT client;
+  RECT child_client;
+  GetClientRect(hWnd, &client);
+  GetClientRect(child, &child_client);
+  int width = client.right - client.left;
+  int height = client.bottom - client.top;
+  // Minimized, the view lays out again when the window is restored.
+  if (width <= 0 || height <= 0)
+    return;
+
+  if (!IsSameSize(client, child_client)) {
+    // The view does not fill the client area, one real resize fixes both.
+    SetWindowPos(child, nullptr, 0, 0, width, height,
+                 SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOMOVE |
+                     SWP_NOACTIVATE | SWP_FRAMECHANGED);
+    refresh_surface_resize_count_++;
+  } else {
+    // The view already has the right size. WM_SIZE makes it send its size
+    // and DPI to the engine again without resizing the window twice.
+    SendMessage(child, WM_SIZE, SIZE_RESTORED, MAKELPARAM(width, height));
+    refresh_size_resend_count_++;
+  }
+}
+
+void WindowManagerPlus::SetRefreshMode(const flutter::EncodableMap& args) {
+  std::string mode =
+      std::get<std::string>(args.at(flutter::EncodableValue("refreshMode")));
+  refresh_mode_ =
+      mode == "nudge" ? RefreshMode::kNudge : RefreshMode::kFrameChange;
+}
+
+flutter::EncodableMap WindowManagerPlus::GetRefreshMetrics() {
+  flutter::EncodableMap metrics = flutter::EncodableMap();
+  metrics[flutter::EncodableValue("refreshes")] =
+      flutter::EncodableValue(refresh_count_);
+  metrics[flutter::EncodableValue("surfaceResizes")] =
+      flutter::EncodableValue(refresh_surface_resize_count_);
+  metrics[flutter::EncodableValue("sizeResends")] =
+      flutter::EncodableValue(refresh_size_resend_count_);
+  return metrics;
 }
 
 void WindowManagerPlus::SetAsFrameless() {
   is_frameless_ = true;
+  UpdateFrameMode();
   HWND hWnd = GetMainWindow();
 
   RECT rect;
@@ -133,11 +549,6 @@ void WindowManagerPlus::SetAsFrameless() {
                    SWP_FRAMECHANGED);
 }
 
-void WindowManagerPlus::WaitUntilReadyToShow() {
-  ::CoCreateInstance(CLSID_TaskbarList, NULL, CLSCTX_INPROC_SERVER,
-                     IID_PPV_ARGS(&taskbar_));
-}
-
 void WindowManagerPlus::Destroy() {
   PostQuitMessage(0);
 }
@@ -283,32 +694,7 @@ int WindowManagerPlus::IsDocked() {
 }
 
 double WindowManagerPlus::GetDpiForHwnd(HWND hWnd) {
-  auto monitor = MonitorFromWindow(hWnd, MONITOR_DEFAULTTONEAREST);
-  UINT newDpiX = 96;  // Default values
-  UINT newDpiY = 96;
-
-  // Dynamically load shcore.dll and get the GetDpiForMonitor function address
-  // We need to do this to ensure Windows 7 support
-  HMODULE shcore = LoadLibrary(TEXT("shcore.dll"));
-  if (shcore) {
-    typedef HRESULT (*GetDpiForMonitor)(HMONITOR, int, UINT*, UINT*);
-
-    GetDpiForMonitor GetDpiForMonitorFunc =
-        (GetDpiForMonitor)GetProcAddress(shcore, "GetDpiForMonitor");
-
-    if (GetDpiForMonitorFunc) {
-      // Use the loaded function if available
-      const int MDT_EFFECTIVE_DPI = 0;
-      if (FAILED(GetDpiForMonitorFunc(monitor, MDT_EFFECTIVE_DPI, &newDpiX,
-                                      &newDpiY))) {
-        // If it fails, set the default values again
-        newDpiX = 96;
-        newDpiY = 96;
-      }
-    }
-    FreeLibrary(shcore);
-  }
-  return ((double)newDpiX);
+  return MonitorCache::GetInstance().FromWindow(hWnd).dpi;
 }
 
 void WindowManagerPlus::Dock(const flutter::EncodableMap& args) {
@@ -359,11 +745,13 @@ void PASCAL WindowManagerPlus::AppBarQuerySetPos(HWND hwnd,
   if ((uEdge == ABE_LEFT) || (uEdge == ABE_RIGHT)) {
     iWidth = pabd->rc.right - pabd->rc.left;
     pabd->rc.top = 0;
-    pabd->rc.bottom = GetSystemMetrics(SM_CYSCREEN);
+    pabd->rc.bottom =
+        MonitorCache::GetInstance().GetPrimary().monitor_rect.bottom;
   } else {
     iHeight = pabd->rc.bottom - pabd->rc.top;
     pabd->rc.left = 0;
-    pabd->rc.right = GetSystemMetrics(SM_CXSCREEN);
+    pabd->rc.right =
+        MonitorCache::GetInstance().GetPrimary().monitor_rect.right;
   }
 
   // Query the system for an approved size and position.
@@ -450,8 +838,10 @@ void WindowManagerPlus::DockAccessBar(HWND hwnd, UINT edge, UINT windowWidth) {
     lprc.left = 0;
     lprc.right = windowWidth;
   } else {
-    lprc.left = GetSystemMetrics(SM_CXSCREEN) - windowWidth;
-    lprc.right = GetSystemMetrics(SM_CXSCREEN);
+    LONG screenWidth =
+        MonitorCache::GetInstance().GetPrimary().monitor_rect.right;
+    lprc.left = screenWidth - windowWidth;
+    lprc.right = screenWidth;
   }
 
   // Specify the structure size and handle to the appbar.
@@ -500,19 +890,13 @@ void WindowManagerPlus::SetFullScreen(const flutter::EncodableMap& args) {
   if (isFullScreen) {  // Set to fullscreen
     ::SendMessage(mainWindow, WM_SYSCOMMAND, SC_MAXIMIZE, 0);
     if (!is_frameless_) {
-      auto monitor = MONITORINFO{};
-      auto placement = WINDOWPLACEMENT{};
-      monitor.cbSize = sizeof(MONITORINFO);
-      placement.length = sizeof(WINDOWPLACEMENT);
-      ::GetWindowPlacement(mainWindow, &placement);
-      ::GetMonitorInfo(
-          ::MonitorFromWindow(mainWindow, MONITOR_DEFAULTTONEAREST), &monitor);
+      RECT monitorRect =
+          MonitorCache::GetInstance().FromWindow(mainWindow).monitor_rect;
       ::SetWindowLongPtr(mainWindow, GWL_STYLE,
                          g_style_before_fullscreen & ~WS_OVERLAPPEDWINDOW);
-      ::SetWindowPos(mainWindow, HWND_TOP, monitor.rcMonitor.left,
-                     monitor.rcMonitor.top,
-                     monitor.rcMonitor.right - monitor.rcMonitor.left,
-                     monitor.rcMonitor.bottom - monitor.rcMonitor.top,
+      ::SetWindowPos(mainWindow, HWND_TOP, monitorRect.left, monitorRect.top,
+                     monitorRect.right - monitorRect.left,
+                     monitorRect.bottom - monitorRect.top,
                      SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
     }
   } else {  // Restore from fullscreen
@@ -563,47 +947,39 @@ void WindowManagerPlus::SetBackgroundColor(const flutter::EncodableMap& args) {
   bool isTransparent = backgroundColorA == 0 && backgroundColorR == 0 &&
                        backgroundColorG == 0 && backgroundColorB == 0;
 
-  HWND hWnd = GetMainWindow();
-  const HINSTANCE hModule = LoadLibrary(TEXT("user32.dll"));
-  if (hModule) {
-    typedef enum _ACCENT_STATE {
-      ACCENT_DISABLED = 0,
-      ACCENT_ENABLE_GRADIENT = 1,
-      ACCENT_ENABLE_TRANSPARENTGRADIENT = 2,
-      ACCENT_ENABLE_BLURBEHIND = 3,
-      ACCENT_ENABLE_ACRYLICBLURBEHIND = 4,
-      ACCENT_ENABLE_HOSTBACKDROP = 5,
-      ACCENT_INVALID_STATE = 6
-    } ACCENT_STATE;
-    struct ACCENTPOLICY {
-      int nAccentState;
-      int nFlags;
-      int nColor;
-      int nAnimationId;
-    };
-    struct WINCOMPATTRDATA {
-      int nAttribute;
-      PVOID pData;
-      ULONG ulDataSize;
-    };
-    typedef BOOL(WINAPI * pSetWindowCompositionAttribute)(HWND,
-                                                          WINCOMPATTRDATA*);
-    const pSetWindowCompositionAttribute SetWindowCompositionAttribute =
-        (pSetWindowCompositionAttribute)GetProcAddress(
-            hModule, "SetWindowCompositionAttribute");
-    if (SetWindowCompositionAttribute) {
-      int32_t accent_state = isTransparent ? ACCENT_ENABLE_TRANSPARENTGRADIENT
-                                           : ACCENT_ENABLE_GRADIENT;
-      ACCENTPOLICY policy = {
-          accent_state, 2,
-          ((backgroundColorA << 24) + (backgroundColorB << 16) +
-           (backgroundColorG << 8) + (backgroundColorR)),
-          0};
-      WINCOMPATTRDATA data = {19, &policy, sizeof(policy)};
-      SetWindowCompositionAttribute(hWnd, &data);
-    }
-    FreeLibrary(hModule);
-  }
+  // The accent color is ABGR.
+  int64_t color = (static_cast<int64_t>(backgroundColorA) << 24) +
+                  (backgroundColorB << 16) + (backgroundColorG << 8) +
+                  backgroundColorR;
+  if (color == background_color_)
+    return;
+
+  const SetWindowCompositionAttributeFunc SetWindowCompositionAttribute =
+      DynamicApi::Get().set_window_composition_attribute;
+  if (SetWindowCompositionAttribute == nullptr)
+    return;
+
+  typedef enum _ACCENT_STATE {
+    ACCENT_DISABLED = 0,
+    ACCENT_ENABLE_GRADIENT = 1,
+    ACCENT_ENABLE_TRANSPARENTGRADIENT = 2,
+    ACCENT_ENABLE_BLURBEHIND = 3,
+    ACCENT_ENABLE_ACRYLICBLURBEHIND = 4,
+    ACCENT_ENABLE_HOSTBACKDROP = 5,
+    ACCENT_INVALID_STATE = 6
+  } ACCENT_STATE;
+  struct ACCENTPOLICY {
+    int nAccentState;
+    int nFlags;
+    int nColor;
+    int nAnimationId;
+  };
+  int32_t accent_state = isTransparent ? ACCENT_ENABLE_TRANSPARENTGRADIENT
+                                       : ACCENT_ENABLE_GRADIENT;
+  ACCENTPOLICY policy = {accent_state, 2, static_cast<int>(color), 0};
+  WindowCompositionAttributeData data = {19, &policy, sizeof(policy)};
+  if (SetWindowCompositionAttribute(GetMainWindow(), &data))
+    background_color_ = color;
 }
 
 flutter::EncodableMap WindowManagerPlus::GetBounds(
@@ -630,6 +1006,26 @@ flutter::EncodableMap WindowManagerPlus::GetBounds(
   return resultMap;
 }
 
+flutter::EncodableMap WindowManagerPlus::GetWindowState(
+    const flutter::EncodableMap& args) {
+  flutter::EncodableMap resultMap = GetBounds(args);
+  resultMap[flutter::EncodableValue("isMaximized")] =
+      flutter::EncodableValue(IsMaximized());
+  resultMap[flutter::EncodableValue("isMinimized")] =
+      flutter::EncodableValue(IsMinimized());
+  resultMap[flutter::EncodableValue("isFullScreen")] =
+      flutter::EncodableValue(IsFullScreen());
+  resultMap[flutter::EncodableValue("isFocused")] =
+      flutter::EncodableValue(IsFocused());
+  resultMap[flutter::EncodableValue("isVisible")] =
+      flutter::EncodableValue(IsVisible());
+  resultMap[flutter::EncodableValue("isAlwaysOnTop")] =
+      flutter::EncodableValue(IsAlwaysOnTop());
+  resultMap[flutter::EncodableValue("opacity")] =
+      flutter::EncodableValue(GetOpacity());
+  return resultMap;
+}
+
 void WindowManagerPlus::SetBounds(const flutter::EncodableMap& args) {
   HWND hwnd = GetMainWindow();
 
@@ -663,9 +1059,158 @@ void WindowManagerPlus::SetBounds(const flutter::EncodableMap& args) {
     uFlags = SWP_NOSIZE;
   }
 
+  auto* null_or_animate = std::get_if<bool>(ValueOrNull(args, "animate"));
+  RECT from;
+  if (null_or_animate != nullptr && *null_or_animate &&
+      GetWindowRect(hwnd, &from)) {
+    bounds_animation_from_ = from;
+    bounds_animation_to_ = from;
+    if (null_or_x != nullptr && null_or_y != nullptr) {
+      bounds_animation_to_ = {x, y, x + (from.right - from.left),
+                              y + (from.bottom - from.top)};
+    }
+    if (null_or_width != nullptr && null_or_height != nullptr) {
+      bounds_animation_to_.right = bounds_animation_to_.left + width;
+      bounds_animation_to_.bottom = bounds_animation_to_.top + height;
+    }
+
+    auto* null_or_duration =
+        std::get_if<int>(ValueOrNull(args, "animationDuration"));
+    bounds_animation_duration_ms_ =
+        null_or_duration != nullptr ? *null_or_duration : 200;
+    auto* null_or_curve =
+        std::get_if<std::string>(ValueOrNull(args, "animationCurve"));
+    bounds_animation_curve_ =
+        null_or_curve != nullptr ? *null_or_curve : "easeInOut";
+    bounds_animation_start_ = std::chrono::steady_clock::now();
+    is_bounds_animating_ = true;
+    // Timers are clamped to USER_TIMER_MINIMUM, so the frames are placed by
+    // the elapsed time rather than by counting ticks.
+    SetTimer(hwnd, kBoundsAnimationTimerId, GetRefreshInterval(hwnd), nullptr);
+    return;
+  }
+
+  if (is_bounds_animating_) {
+    KillTimer(hwnd, kBoundsAnimationTimerId);
+    is_bounds_animating_ = false;
+  }
   SetWindowPos(hwnd, HWND_TOP, x, y, width, height, uFlags);
 }
 
+bool WindowManagerPlus::StepBoundsAnimation() {
+  HWND hwnd = GetMainWindow();
+  if (!is_bounds_animating_) {
+    KillTimer(hwnd, kBoundsAnimationTimerId);
+    return false;
+  }
+
+  double elapsed_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() -
+                          bounds_animation_start_)
+                          .count();
+  double t = bounds_animation_duration_ms_ > 0
+                 ? (std::min)(elapsed_ms / bounds_animation_duration_ms_, 1.0)
+                 : 1.0;
+  double progress = EaseBoundsAnimation(bounds_animation_curve_, t);
+  auto lerp = [progress](LONG from, LONG to) {
+    return static_cast<int>(std::lround(from + (to - from) * progress));
+  };
+  int left = lerp(bounds_animation_from_.left, bounds_animation_to_.left);
+  int top = lerp(bounds_animation_from_.top, bounds_animation_to_.top);
+  int right = lerp(bounds_animation_from_.right, bounds_animation_to_.right);
+  int bottom =
+      lerp(bounds_animation_from_.bottom, bounds_animation_to_.bottom);
+  SetWindowPos(hwnd, nullptr, left, top, right - left, bottom - top,
+               SWP_NOZORDER | SWP_NOACTIVATE);
+
+  if (t >= 1.0) {
+    KillTimer(hwnd, kBoundsAnimationTimerId);
+    is_bounds_animating_ = false;
+    return false;
+  }
+  return true;
+}
+
+bool WindowManagerPlus::ApplyLayout(const flutter::EncodableMap& args) {
+  double devicePixelRatio =
+      std::get<double>(args.at(flutter::EncodableValue("devicePixelRatio")));
+  const auto& layout = std::get<flutter::EncodableList>(
+      args.at(flutter::EncodableValue("layout")));
+
+  struct Placement {
+    HWND hwnd;
+    int x, y, width, height;
+    UINT flags;
+    bool has_z_order;
+    int64_t z_order;
+  };
+  std::vector<Placement> placements;
+  for (const auto& encoded_entry : layout) {
+    const auto& entry = std::get<flutter::EncodableMap>(encoded_entry);
+    auto manager = registry_.FindManager(
+        entry.at(flutter::EncodableValue("windowId")).LongValue());
+    if (!manager) {
+      continue;
+    }
+
+    Placement placement = {manager->GetMainWindow(), 0, 0, 0, 0,
+                           SWP_NOACTIVATE, false, 0};
+    auto* null_or_x = std::get_if<double>(ValueOrNull(entry, "x"));
+    auto* null_or_y = std::get_if<double>(ValueOrNull(entry, "y"));
+    auto* null_or_width = std::get_if<double>(ValueOrNull(entry, "width"));
+    auto* null_or_height = std::get_if<double>(ValueOrNull(entry, "height"));
+    if (null_or_x != nullptr && null_or_y != nullptr) {
+      placement.x = static_cast<int>(*null_or_x * devicePixelRatio);
+      placement.y = static_cast<int>(*null_or_y * devicePixelRatio);
+    } else {
+      placement.flags |= SWP_NOMOVE;
+    }
+    if (null_or_width != nullptr && null_or_height != nullptr) {
+      placement.width = static_cast<int>(*null_or_width * devicePixelRatio);
+      placement.height = static_cast<int>(*null_or_height * devicePixelRatio);
+    } else {
+      placement.flags |= SWP_NOSIZE;
+    }
+    const auto* z_order = ValueOrNull(entry, "zOrder");
+    if (z_order != nullptr && !z_order->IsNull()) {
+      placement.has_z_order = true;
+      placement.z_order = z_order->LongValue();
+    } else {
+      placement.flags |= SWP_NOZORDER;
+    }
+    placements.push_back(placement);
+  }
+  if (placements.empty()) {
+    return true;
+  }
+
+  // Windows with a zOrder are stacked below each other in ascending order,
+  // starting at the top.
+  std::stable_sort(placements.begin(), placements.end(),
+                   [](const Placement& a, const Placement& b) {
+                     if (a.has_z_order != b.has_z_order) {
+                       return a.has_z_order;
+                     }
+                     return a.has_z_order && a.z_order < b.z_order;
+                   });
+
+  // All windows are moved with a single repaint once EndDeferWindowPos runs.
+  HDWP hdwp = BeginDeferWindowPos(static_cast<int>(placements.size()));
+  HWND insert_after = HWND_TOP;
+  for (const auto& placement : placements) {
+    if (hdwp == nullptr) {
+      return false;
+    }
+    hdwp = DeferWindowPos(hdwp, placement.hwnd, insert_after, placement.x,
+                          placement.y, placement.width, placement.height,
+                          placement.flags);
+    if (placement.has_z_order) {
+      insert_after = placement.hwnd;
+    }
+  }
+  return hdwp != nullptr && EndDeferWindowPos(hdwp);
+}
+
 void WindowManagerPlus::SetMinimumSize(const flutter::EncodableMap& args) {
   double devicePixelRatio =
       std::get<double>(args.at(flutter::EncodableValue("devicePixelRatio")));
@@ -678,6 +1223,7 @@ void WindowManagerPlus::SetMinimumSize(const flutter::EncodableMap& args) {
     point.x = static_cast<LONG>(width);
     point.y = static_cast<LONG>(height);
     minimum_size_ = point;
+    UpdateTrackSizeLimits();
   }
 }
 
@@ -693,9 +1239,58 @@ void WindowManagerPlus::SetMaximumSize(const flutter::EncodableMap& args) {
     point.x = static_cast<LONG>(width);
     point.y = static_cast<LONG>(height);
     maximum_size_ = point;
+    UpdateTrackSizeLimits();
   }
 }
 
+void WindowManagerPlus::SetWindowConstraints(
+    const flutter::EncodableMap& args) {
+  double devicePixelRatio =
+      std::get<double>(args.at(flutter::EncodableValue("devicePixelRatio")));
+
+  auto* null_or_minimum_width =
+      std::get_if<double>(ValueOrNull(args, "minimumWidth"));
+  auto* null_or_minimum_height =
+      std::get_if<double>(ValueOrNull(args, "minimumHeight"));
+  if (null_or_minimum_width != nullptr && null_or_minimum_height != nullptr &&
+      *null_or_minimum_width >= 0 && *null_or_minimum_height >= 0) {
+    pixel_ratio_ = devicePixelRatio;
+    minimum_size_ = {static_cast<LONG>(*null_or_minimum_width),
+                     static_cast<LONG>(*null_or_minimum_height)};
+  }
+
+  auto* null_or_maximum_width =
+      std::get_if<double>(ValueOrNull(args, "maximumWidth"));
+  auto* null_or_maximum_height =
+      std::get_if<double>(ValueOrNull(args, "maximumHeight"));
+  if (null_or_maximum_width != nullptr && null_or_maximum_height != nullptr &&
+      *null_or_maximum_width >= 0 && *null_or_maximum_height >= 0) {
+    pixel_ratio_ = devicePixelRatio;
+    maximum_size_ = {static_cast<LONG>(*null_or_maximum_width),
+                     static_cast<LONG>(*null_or_maximum_height)};
+  }
+
+  auto* null_or_aspect_ratio =
+      std::get_if<double>(ValueOrNull(args, "aspectRatio"));
+  if (null_or_aspect_ratio != nullptr) {
+    aspect_ratio_ = *null_or_aspect_ratio;
+  }
+
+  UpdateTrackSizeLimits();
+
+  if (ValueOrNull(args, "x") != nullptr ||
+      ValueOrNull(args, "width") != nullptr) {
+    SetBounds(args);
+  }
+}
+
+void WindowManagerPlus::UpdateTrackSizeLimits() {
+  min_track_size_limit_ = ScaleTrackSizeLimit(
+      {minimum_size_.x, minimum_size_.y}, 0, pixel_ratio_);
+  max_track_size_limit_ = ScaleTrackSizeLimit(
+      {maximum_size_.x, maximum_size_.y}, -1, pixel_ratio_);
+}
+
 bool WindowManagerPlus::IsResizable() {
   return is_resizable_;
 }
@@ -803,11 +1398,14 @@ void WindowManagerPlus::SetTitle(const flutter::EncodableMap& args) {
 }
 
 void WindowManagerPlus::SetTitleBarStyle(const flutter::EncodableMap& args) {
-  title_bar_style_ =
+  std::string titleBarStyle =
       std::get<std::string>(args.at(flutter::EncodableValue("titleBarStyle")));
+  title_bar_style_ = titleBarStyle == "hidden" ? TitleBarStyle::kHidden
+                                               : TitleBarStyle::kNormal;
   // Enables the ability to go from setAsFrameless() to
   // TitleBarStyle.normal/hidden
   is_frameless_ = false;
+  UpdateFrameMode();
 
   MARGINS margins = {0, 0, 0, 0};
   HWND hWnd = GetMainWindow();
@@ -819,6 +1417,14 @@ void WindowManagerPlus::SetTitleBarStyle(const flutter::EncodableMap& args) {
                    SWP_FRAMECHANGED);
 }
 
+void WindowManagerPlus::UpdateFrameMode() {
+  frame_mode_ = 0;
+  if (is_frameless_)
+    frame_mode_ |= kFrameModeFrameless;
+  if (title_bar_style_ == TitleBarStyle::kHidden)
+    frame_mode_ |= kFrameModeHiddenTitleBar;
+}
+
 int WindowManagerPlus::GetTitleBarHeight() {
   HWND hWnd = GetMainWindow();
 
@@ -841,60 +1447,173 @@ void WindowManagerPlus::SetSkipTaskbar(const flutter::EncodableMap& args) {
   is_skip_taskbar_ =
       std::get<bool>(args.at(flutter::EncodableValue("isSkipTaskbar")));
 
-  HWND hWnd = GetMainWindow();
-
-  LPVOID lp = NULL;
-  CoInitialize(lp);
+  if (is_skip_taskbar_ != is_taskbar_tab_deleted_) {
+    ITaskbarList3* taskbar = TaskbarList::GetInstance().Get();
+    if (taskbar == nullptr)
+      return;
 
-  taskbar_->HrInit();
-  if (!is_skip_taskbar_)
-    taskbar_->AddTab(hWnd);
-  else
-    taskbar_->DeleteTab(hWnd);
+    HWND hWnd = GetMainWindow();
+    if (!is_skip_taskbar_)
+      taskbar->AddTab(hWnd);
+    else
+      taskbar->DeleteTab(hWnd);
+    is_taskbar_tab_deleted_ = is_skip_taskbar_;
+  }
 }
 
 void WindowManagerPlus::SetProgressBar(const flutter::EncodableMap& args) {
   double progress =
       std::get<double>(args.at(flutter::EncodableValue("progress")));
 
-  HWND hWnd = GetMainWindow();
-  taskbar_->SetProgressState(hWnd, TBPF_INDETERMINATE);
-  taskbar_->SetProgressValue(hWnd, static_cast<int32_t>(progress * 100),
-                             static_cast<int32_t>(100));
-
-  if (progress < 0) {
-    taskbar_->SetProgressState(hWnd, TBPF_NOPROGRESS);
-    taskbar_->SetProgressValue(hWnd, static_cast<int32_t>(0),
-                               static_cast<int32_t>(0));
+  // Without a state, a progress below 0 hides the bar and one above 1 makes
+  // it indeterminate.
+  TBPFLAG state = TBPF_NORMAL;
+  if (auto* null_or_state =
+          std::get_if<std::string>(ValueOrNull(args, "state"))) {
+    if (*null_or_state == "none")
+      state = TBPF_NOPROGRESS;
+    else if (*null_or_state == "indeterminate")
+      state = TBPF_INDETERMINATE;
+    else if (*null_or_state == "error")
+      state = TBPF_ERROR;
+    else if (*null_or_state == "paused")
+      state = TBPF_PAUSED;
+  } else if (progress < 0) {
+    state = TBPF_NOPROGRESS;
   } else if (progress > 1) {
-    taskbar_->SetProgressState(hWnd, TBPF_INDETERMINATE);
-    taskbar_->SetProgressValue(hWnd, static_cast<int32_t>(100),
-                               static_cast<int32_t>(100));
-  } else {
-    taskbar_->SetProgressState(hWnd, TBPF_INDETERMINATE);
-    taskbar_->SetProgressValue(hWnd, static_cast<int32_t>(progress * 100),
-                               static_cast<int32_t>(100));
+    state = TBPF_INDETERMINATE;
+  }
+
+  // A bar with a value is only redrawn at whole percents.
+  bool has_value = state != TBPF_NOPROGRESS && state != TBPF_INDETERMINATE;
+  ULONGLONG value =
+      has_value ? static_cast<ULONGLONG>(std::clamp(progress, 0.0, 1.0) * 100)
+                : 0;
+
+  pending_progress_update_count_++;
+  pending_progress_state_ = state;
+  pending_progress_value_ = value;
+
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     now - progress_bar_updated_at_)
+                     .count();
+  if (state != progress_state_ || elapsed >= progress_bar_update_interval_) {
+    ApplyProgressBar();
+  } else if (!is_progress_bar_timer_set_) {
+    SetTimer(GetMainWindow(), kProgressBarTimerId,
+             progress_bar_update_interval_ - static_cast<UINT>(elapsed),
+             nullptr);
+    is_progress_bar_timer_set_ = true;
   }
 }
 
-void WindowManagerPlus::SetIcon(const flutter::EncodableMap& args) {
-  std::string iconPath =
-      std::get<std::string>(args.at(flutter::EncodableValue("iconPath")));
+void WindowManagerPlus::ApplyProgressBar() {
+  HWND hWnd = GetMainWindow();
+  if (is_progress_bar_timer_set_) {
+    KillTimer(hWnd, kProgressBarTimerId);
+    is_progress_bar_timer_set_ = false;
+  }
+  progress_bar_updated_at_ = std::chrono::steady_clock::now();
+
+  bool state_changed = pending_progress_state_ != progress_state_;
+  // Leaving the states without a value resets the value the taskbar shows.
+  bool had_value = progress_state_ != TBPF_NOPROGRESS &&
+                   progress_state_ != TBPF_INDETERMINATE;
+  bool has_value = pending_progress_state_ != TBPF_NOPROGRESS &&
+                   pending_progress_state_ != TBPF_INDETERMINATE;
+  bool value_changed =
+      has_value && (!had_value || pending_progress_value_ != progress_value_);
+  int64_t calls_needed = 2 * pending_progress_update_count_;
+  pending_progress_update_count_ = 0;
+  if (!state_changed && !value_changed && calls_needed == 0)
+    return;
 
-  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  // Without a taskbar nothing is made, and nothing is counted as elided.
+  ITaskbarList3* taskbar = TaskbarList::GetInstance().Get();
+  if (taskbar == nullptr)
+    return;
+  int64_t calls_made = 0;
+  if (state_changed) {
+    taskbar->SetProgressState(hWnd, pending_progress_state_);
+    calls_made++;
+  }
+  if (value_changed) {
+    taskbar->SetProgressValue(hWnd, pending_progress_value_, 100);
+    calls_made++;
+  }
+  // ResetProgressBar applies without a SetProgressBar to stand for.
+  elided_progress_bar_call_count_ += std::max<int64_t>(
+      calls_needed - calls_made, 0);
+  progress_state_ = pending_progress_state_;
+  progress_value_ = pending_progress_value_;
+}
+
+void WindowManagerPlus::ResetProgressBar() {
+  // A new taskbar button shows no progress.
+  progress_state_ = TBPF_NOPROGRESS;
+  progress_value_ = 0;
+  ApplyProgressBar();
+}
 
-  HICON hIconSmall =
-      (HICON)(LoadImage(NULL, (LPCWSTR)(converter.from_bytes(iconPath).c_str()),
-                        IMAGE_ICON, 16, 16, LR_LOADFROMFILE));
+void WindowManagerPlus::SetProgressBarUpdateInterval(
+    const flutter::EncodableMap& args) {
+  int interval = std::get<int>(args.at(flutter::EncodableValue("interval")));
+  progress_bar_update_interval_ =
+      interval > 0 ? static_cast<UINT>(interval) : 0;
+}
 
-  HICON hIconLarge =
-      (HICON)(LoadImage(NULL, (LPCWSTR)(converter.from_bytes(iconPath).c_str()),
-                        IMAGE_ICON, 32, 32, LR_LOADFROMFILE));
+int64_t WindowManagerPlus::GetElidedProgressBarCallCount() {
+  return elided_progress_bar_call_count_;
+}
+
+void WindowManagerPlus::SetIcon(const flutter::EncodableMap& args) {
+  IconSource source;
+  if (auto* bytes = std::get_if<std::vector<uint8_t>>(
+          ValueOrNull(args, "iconBytes"))) {
+    source.bytes = *bytes;
+  } else {
+    source.path =
+        std::get<std::string>(args.at(flutter::EncodableValue("iconPath")));
+  }
+
+  HWND hWnd = GetMainWindow();
+  UINT dpi = MonitorCache::GetInstance().FromWindow(hWnd).dpi;
+
+  // Decoding happens off this thread, the icons are shown by
+  // ApplyPendingIcon once they are ready, right away if they are cached.
+  IconCache& icon_cache = IconCache::GetInstance();
+  std::string key = icon_cache.Request(source, dpi, hWnd);
+  if (!pending_icon_key_.empty())
+    icon_cache.Release(pending_icon_key_);
+  pending_icon_key_ = key;
+  ApplyPendingIcon();
+}
+
+void WindowManagerPlus::ApplyPendingIcon() {
+  IconCache& icon_cache = IconCache::GetInstance();
+  IconPair icons;
+  if (pending_icon_key_.empty() ||
+      !icon_cache.GetIcons(pending_icon_key_, &icons)) {
+    return;
+  }
+  // The icons shown stay if the new ones couldn't be decoded.
+  if (icons.small_icon == nullptr) {
+    icon_cache.Release(pending_icon_key_);
+    pending_icon_key_.clear();
+    return;
+  }
 
   HWND hWnd = GetMainWindow();
+  SendMessage(hWnd, WM_SETICON, ICON_SMALL, (LPARAM)icons.small_icon);
+  SendMessage(hWnd, WM_SETICON, ICON_BIG, (LPARAM)icons.big_icon);
 
-  SendMessage(hWnd, WM_SETICON, ICON_SMALL, (LPARAM)hIconSmall);
-  SendMessage(hWnd, WM_SETICON, ICON_BIG, (LPARAM)hIconLarge);
+  // Released after WM_SETICON, so the icons still shown are never the ones
+  // Trim destroys.
+  if (!icon_key_.empty())
+    icon_cache.Release(icon_key_);
+  icon_key_ = std::move(pending_icon_key_);
+  pending_icon_key_.clear();
 }
 
 bool WindowManagerPlus::HasShadow() {
@@ -1018,9 +1737,128 @@ void WindowManagerPlus::StartResizing(const flutter::EncodableMap& args) {
               MAKELPARAM(cursorPos.x, cursorPos.y));
 }
 
+void WindowManagerPlus::SetEventCoalescingInterval(
+    const flutter::EncodableMap& args) {
+  int interval = std::get<int>(args.at(flutter::EncodableValue("interval")));
+  event_coalescing_interval_ = interval > 0 ? static_cast<UINT>(interval) : 0;
+}
+
+int64_t WindowManagerPlus::GetCoalescedEventCount() {
+  return coalesced_event_count_;
+}
+
+void WindowManagerPlus::SetEventFastPath(const flutter::EncodableMap& args) {
+  bool enabled = std::get<bool>(args.at(flutter::EncodableValue("enabled")));
+  std::lock_guard<std::mutex> lock(event_rings_mutex_);
+  if (enabled && event_ring_ == nullptr) {
+    event_ring_ = std::make_shared<WindowEventRing>();
+    event_rings_[id] = event_ring_;
+  } else if (!enabled && event_ring_ != nullptr) {
+    event_rings_.erase(id);
+    event_ring_ = nullptr;
+  }
+}
+
+bool WindowManagerPlus::PushFastPathEvent(int32_t event_id) {
+  if (event_ring_ == nullptr)
+    return false;
+
+  RECT rect;
+  GetWindowRect(GetMainWindow(), &rect);
+  WindowManagerPlusEvent event = {};
+  event.event_id = event_id;
+  event.window_id = id;
+  event.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+  event.x = rect.left;
+  event.y = rect.top;
+  event.width = rect.right - rect.left;
+  event.height = rect.bottom - rect.top;
+  return event_ring_->Push(event);
+}
+
+// static
+int32_t WindowManagerPlus::DrainEvents(int64_t window_id,
+                                       WindowManagerPlusEvent* out,
+                                       int32_t capacity) {
+  if (out == nullptr || capacity <= 0)
+    return 0;
+
+  std::shared_ptr<WindowEventRing> ring;
+  {
+    std::lock_guard<std::mutex> lock(event_rings_mutex_);
+    auto it = event_rings_.find(window_id);
+    if (it == event_rings_.end())
+      return 0;
+    ring = it->second;
+  }
+  return static_cast<int32_t>(
+      ring->Drain(out, static_cast<size_t>(capacity)));
+}
+
+void WindowManagerPlus::SubscribeGlobalEvents(
+    const flutter::EncodableMap& args) {
+  const auto& events = args.at(flutter::EncodableValue("events"));
+  if (events.IsNull()) {
+    global_event_mask_ = ALL_WINDOW_EVENTS;
+    return;
+  }
+
+  uint32_t mask = 0;
+  for (const auto& event : std::get<flutter::EncodableList>(events)) {
+    if (const auto* name = std::get_if<std::string>(&event)) {
+      mask |= GetWindowEventMask(*name);
+    }
+  }
+  global_event_mask_ = mask;
+}
+
 }  // namespace window_manager_plus
 
 void WindowManagerPlusPluginSetWindowCreatedCallback(
     WindowManagerPlusPluginWindowCreatedCallback callback) {
   window_manager_plus::g_window_created_callback = callback;
-}
\ No newline at end of file
+}
+
+int32_t WindowManagerPlusPluginDrainEvents(int64_t window_id,
+                                           WindowManagerPlusEvent* out,
+                                           int32_t capacity) {
+  return window_manager_plus::WindowManagerPlus::DrainEvents(window_id, out,
+                                                             capacity);
+}
+
+WindowManagerPlusEvent* WindowManagerPlusPluginAllocateEvents(
+    int32_t capacity) {
+  if (capacity <= 0)
+    return nullptr;
+  return static_cast<WindowManagerPlusEvent*>(
+      calloc(static_cast<size_t>(capacity), sizeof(WindowManagerPlusEvent)));
+}
+
+void WindowManagerPlusPluginFreeEvents(void* events) {
+  free(events);
+}
+
+using window_manager_plus::SharedBufferArena;
+
+int64_t WindowManagerPlusPluginAllocateBuffer(int64_t size) {
+  return SharedBufferArena::GetInstance().Allocate(size);
+}
+
+uint8_t* WindowManagerPlusPluginGetBufferData(int64_t buffer_id) {
+  return SharedBufferArena::GetInstance().GetData(buffer_id);
+}
+
+int64_t WindowManagerPlusPluginGetBufferSize(int64_t buffer_id) {
+  return SharedBufferArena::GetInstance().GetSize(buffer_id);
+}
+
+bool WindowManagerPlusPluginRetainBuffer(int64_t buffer_id) {
+  return SharedBufferArena::GetInstance().Retain(buffer_id);
+}
+
+void WindowManagerPlusPluginReleaseBuffer(void* buffer_id) {
+  SharedBufferArena::GetInstance().Release(
+      static_cast<int64_t>(reinterpret_cast<intptr_t>(buffer_id)));
+}
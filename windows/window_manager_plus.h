@@ -4,35 +4,111 @@
 #include <shobjidl_core.h>
 
 #include "include/window_manager_plus/window_manager_plus_plugin.h"
+#include "event_ring_buffer.h"
+#include "window_proc_core.h"
+#include "window_registry.h"
 
 #include <flutter/method_channel.h>
 #include <flutter/plugin_registrar_windows.h>
 #include <flutter/standard_method_codec.h>
 
+#include <chrono>
 #include <codecvt>
 #include <dwmapi.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <string_view>
+#include <vector>
 
-#define STATE_NORMAL 0
-#define STATE_MAXIMIZED 1
-#define STATE_MINIMIZED 2
-#define STATE_FULLSCREEN_ENTERED 3
-#define STATE_DOCKED 4
+// Subscribes a window manager to every global event, see
+// WindowManagerPlus::global_event_mask_.
+#define ALL_WINDOW_EVENTS 0xFFFFFFFF
+
+// First entrypoint argument of a window started by the window pool, followed
+// by its pool token. The Dart side trades both for the real window arguments
+// with WindowManagerPlus.resolveEntrypointArguments.
+#define POOLED_WINDOW_ARGUMENT "--window-manager-plus-pooled"
 
 namespace window_manager_plus {
 
+enum class TitleBarStyle : uint8_t { kNormal, kHidden };
+
+// How ForceRefresh and ForceChildRefresh make the window lay out again.
+// kFrameChange resizes the Flutter view at most once per refresh, kNudge
+// resizes it by one pixel and back like older versions did.
+enum class RefreshMode : uint8_t { kFrameChange, kNudge };
+
+using WindowEventRing = EventRingBuffer<WindowManagerPlusEvent>;
+
+// Identifies the timer that steps the animation of SetBounds with "animate".
+constexpr UINT_PTR kBoundsAnimationTimerId = 0x574D51;
+
+// Identifies the timer that applies a rate limited SetProgressBar.
+constexpr UINT_PTR kProgressBarTimerId = 0x574D52;
+
+// A hidden window created ahead of time by the window pool, see
+// WindowManagerPlus::SetWindowPoolSize.
+struct PooledWindow {
+  int64_t token = 0;
+  std::shared_ptr<FlutterWindow> window;
+  // Completed with the window id and arguments when createWindow hands the
+  // window out. Null until the Dart side of the window is waiting for it.
+  std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> assignment;
+};
+
+// A window whose engine has shut down, waiting to be released by
+// WindowManagerPlus::ReleaseWindows.
+struct ReleasedWindow {
+  std::shared_ptr<FlutterWindow> window;
+  std::chrono::steady_clock::time_point queued_at;
+};
+
+// When createWindow was called for a window that has not drawn its first
+// frame yet, and whether it was served from the window pool.
+struct PendingFirstFrame {
+  std::chrono::steady_clock::time_point created_at;
+  bool from_pool = false;
+};
+
 class WindowManagerPlus {
  public:
   WindowManagerPlus();
 
   virtual ~WindowManagerPlus();
 
-  inline static int64_t autoincrementId_ = 0;
-  inline static std::map<int64_t, std::shared_ptr<FlutterWindow>> windows_ = {};
-  inline static std::map<int64_t, std::shared_ptr<WindowManagerPlus>>
-      windowManagers_ = {};
+  // Windows created by createWindow and the window managers of all windows.
+  inline static WindowRegistry<FlutterWindow, WindowManagerPlus> registry_ =
+      {};
+
+  // Hidden windows kept ready for createWindow, refilled up to
+  // window_pool_size_ whenever one is handed out.
+  inline static std::vector<PooledWindow> window_pool_ = {};
+  inline static size_t window_pool_size_ = 0;
+  inline static int64_t window_pool_token_ = 0;
+  inline static UINT_PTR window_pool_refill_timer_ = 0;
+  inline static int64_t window_pool_hits_ = 0;
+  inline static int64_t window_pool_misses_ = 0;
+  inline static std::map<int64_t, PendingFirstFrame> pending_first_frames_ =
+      {};
+  // Windows are released from a message posted to this message-only window,
+  // after the engine that closed them has finished shutting down.
+  inline static HWND window_release_hwnd_ = nullptr;
+  inline static std::vector<ReleasedWindow> windows_to_release_ = {};
+  inline static int64_t released_window_count_ = 0;
+  // Time windows spent in windows_to_release_, in milliseconds.
+  inline static double window_release_ms_ = 0;
+  // Time from createWindow to the first rasterized frame, in milliseconds.
+  inline static double pooled_first_frame_ms_ = 0;
+  inline static int64_t pooled_first_frame_count_ = 0;
+  inline static double unpooled_first_frame_ms_ = 0;
+  inline static int64_t unpooled_first_frame_count_ = 0;
+  // Event rings of the windows with the event fast path enabled. Unlike
+  // registry_, this is also read from the UI threads draining the rings.
+  inline static std::mutex event_rings_mutex_;
+  inline static std::map<int64_t, std::shared_ptr<WindowEventRing>>
+      event_rings_ = {};
 
   std::unique_ptr<
       flutter::MethodChannel<flutter::EncodableValue>,
@@ -46,6 +122,9 @@ class WindowManagerPlus {
 
   int64_t id = -1;
   HWND native_window;
+  // Global events of other windows this window manager receives, one bit per
+  // event name as returned by GetWindowEventMask.
+  uint32_t global_event_mask_ = ALL_WINDOW_EVENTS;
   int last_state = STATE_NORMAL;
   bool has_shadow_ = false;
   bool is_always_on_bottom_ = false;
@@ -55,21 +134,85 @@ class WindowManagerPlus {
   POINT minimum_size_ = {0, 0};
   POINT maximum_size_ = {-1, -1};
   double pixel_ratio_ = 1;
+  // minimum_size_ and maximum_size_ scaled by pixel_ratio_, so
+  // WM_GETMINMAXINFO does no arithmetic. Kept by UpdateTrackSizeLimits.
+  ProcPoint min_track_size_limit_ = {0, 0};
+  ProcPoint max_track_size_limit_ = {-1, -1};
   bool is_resizable_ = true;
   int is_docked_ = 0;
   bool is_registered_for_docking_ = false;
   bool is_skip_taskbar_ = true;
-  std::string title_bar_style_ = "normal";
+  // Set once SetSkipTaskbar removed the taskbar button, until it adds it
+  // back. Windows have a button to begin with, so no taskbar list is needed
+  // to keep it.
+  bool is_taskbar_tab_deleted_ = false;
+  TitleBarStyle title_bar_style_ = TitleBarStyle::kNormal;
+  uint8_t frame_mode_ = 0;
   double opacity_ = 1;
+  // The ABGR accent color SetBackgroundColor applied last, -1 if none, so
+  // setting the same color again is skipped.
+  int64_t background_color_ = -1;
 
   bool is_resizing_ = false;
   bool is_moving_ = false;
 
+  // "move" / "resize" events raised during a drag are held here and emitted
+  // at most once per event_coalescing_interval_ milliseconds.
+  UINT event_coalescing_interval_ = 16;
+  bool is_move_event_pending_ = false;
+  bool is_resize_event_pending_ = false;
+  bool is_event_coalescing_timer_set_ = false;
+  int64_t coalesced_event_count_ = 0;
+  // Set while the event fast path is enabled: "move" / "resize" are pushed
+  // here instead of being sent over the channel.
+  std::shared_ptr<WindowEventRing> event_ring_ = nullptr;
+
+  // Animation started by SetBounds with "animate", stepped on every
+  // kBoundsAnimationTimerId tick until the window reaches
+  // bounds_animation_to_.
+  bool is_bounds_animating_ = false;
+  RECT bounds_animation_from_ = {};
+  RECT bounds_animation_to_ = {};
+  std::string bounds_animation_curve_ = "easeInOut";
+  double bounds_animation_duration_ms_ = 0;
+  std::chrono::steady_clock::time_point bounds_animation_start_;
+
+  // The taskbar progress last applied to the main window, and the one
+  // SetProgressBar asked for. A change of value is applied at most once per
+  // progress_bar_update_interval_ milliseconds, a change of state right away.
+  TBPFLAG progress_state_ = TBPF_NOPROGRESS;
+  ULONGLONG progress_value_ = 0;
+  TBPFLAG pending_progress_state_ = TBPF_NOPROGRESS;
+  ULONGLONG pending_progress_value_ = 0;
+  UINT progress_bar_update_interval_ = 50;
+  bool is_progress_bar_timer_set_ = false;
+  std::chrono::steady_clock::time_point progress_bar_updated_at_;
+  // Each SetProgressBar stands for a SetProgressState and a SetProgressValue
+  // call. ApplyProgressBar counts the ones it did not make, because nothing
+  // changed or a later update replaced them, for the SetProgressBar calls
+  // since the last apply.
+  int64_t pending_progress_update_count_ = 0;
+  int64_t elided_progress_bar_call_count_ = 0;
+
+  RefreshMode refresh_mode_ = RefreshMode::kFrameChange;
+  // ForceRefresh and ForceChildRefresh calls, how many times they made the
+  // Flutter view resize its surface, and how many times they only sent it
+  // its unchanged size again.
+  int64_t refresh_count_ = 0;
+  int64_t refresh_surface_resize_count_ = 0;
+  int64_t refresh_size_resend_count_ = 0;
+
+  // IconCache keys of the icons shown and of the ones SetIcon asked for
+  // last, each holding a reference. pending_icon_key_ is empty once shown.
+  std::string icon_key_;
+  std::string pending_icon_key_;
+
   HWND GetMainWindow();
   void WindowManagerPlus::ForceRefresh();
   void WindowManagerPlus::ForceChildRefresh();
+  void WindowManagerPlus::SetRefreshMode(const flutter::EncodableMap& args);
+  flutter::EncodableMap WindowManagerPlus::GetRefreshMetrics();
   void WindowManagerPlus::SetAsFrameless();
-  void WindowManagerPlus::WaitUntilReadyToShow();
   void WindowManagerPlus::Destroy();
   void WindowManagerPlus::Close();
   bool WindowManagerPlus::IsPreventClose();
@@ -96,9 +239,23 @@ class WindowManagerPlus {
   void WindowManagerPlus::SetBackgroundColor(const flutter::EncodableMap& args);
   flutter::EncodableMap WindowManagerPlus::GetBounds(
       const flutter::EncodableMap& args);
+  // Returns GetBounds together with every is* flag and the opacity, so
+  // restoring a window's state takes a single method call.
+  flutter::EncodableMap WindowManagerPlus::GetWindowState(
+      const flutter::EncodableMap& args);
   void WindowManagerPlus::SetBounds(const flutter::EncodableMap& args);
+  // Moves the window to the current frame of the bounds animation. Returns
+  // false once the animation has finished.
+  bool WindowManagerPlus::StepBoundsAnimation();
   void WindowManagerPlus::SetMinimumSize(const flutter::EncodableMap& args);
   void WindowManagerPlus::SetMaximumSize(const flutter::EncodableMap& args);
+  // Applies the minimum size, maximum size and aspect ratio in |args| and,
+  // if it has bounds, calls SetBounds.
+  void WindowManagerPlus::SetWindowConstraints(
+      const flutter::EncodableMap& args);
+  // Rescales min_track_size_limit_ and max_track_size_limit_, call it after
+  // minimum_size_, maximum_size_ or pixel_ratio_ change.
+  void WindowManagerPlus::UpdateTrackSizeLimits();
   bool WindowManagerPlus::IsResizable();
   void WindowManagerPlus::SetResizable(const flutter::EncodableMap& args);
   bool WindowManagerPlus::IsMinimizable();
@@ -118,7 +275,18 @@ class WindowManagerPlus {
   bool WindowManagerPlus::IsSkipTaskbar();
   void WindowManagerPlus::SetSkipTaskbar(const flutter::EncodableMap& args);
   void WindowManagerPlus::SetProgressBar(const flutter::EncodableMap& args);
+  // Makes the taskbar show pending_progress_state_ and
+  // pending_progress_value_, skipping the calls that would change nothing.
+  void WindowManagerPlus::ApplyProgressBar();
+  // Forgets what the taskbar shows, for a taskbar button that was recreated.
+  void WindowManagerPlus::ResetProgressBar();
+  void WindowManagerPlus::SetProgressBarUpdateInterval(
+      const flutter::EncodableMap& args);
+  int64_t WindowManagerPlus::GetElidedProgressBarCallCount();
   void WindowManagerPlus::SetIcon(const flutter::EncodableMap& args);
+  // Shows the icons of pending_icon_key_ if they are decoded by now. Called
+  // by SetIcon and on IconCache::GetDecodedMessage().
+  void WindowManagerPlus::ApplyPendingIcon();
   bool WindowManagerPlus::HasShadow();
   void WindowManagerPlus::SetHasShadow(const flutter::EncodableMap& args);
   double WindowManagerPlus::GetOpacity();
@@ -129,19 +297,61 @@ class WindowManagerPlus {
   void WindowManagerPlus::PopUpWindowMenu(const flutter::EncodableMap& args);
   void WindowManagerPlus::StartDragging();
   void WindowManagerPlus::StartResizing(const flutter::EncodableMap& args);
+  void WindowManagerPlus::SetEventCoalescingInterval(
+      const flutter::EncodableMap& args);
+  int64_t WindowManagerPlus::GetCoalescedEventCount();
+  void WindowManagerPlus::SetEventFastPath(const flutter::EncodableMap& args);
+  // Records |event_id| in event_ring_. Returns false if the fast path is
+  // disabled or the ring is full, in which case the event must go over the
+  // channel.
+  bool WindowManagerPlus::PushFastPathEvent(int32_t event_id);
+  static int32_t WindowManagerPlus::DrainEvents(int64_t window_id,
+                                                WindowManagerPlusEvent* out,
+                                                int32_t capacity);
+
+  void WindowManagerPlus::SubscribeGlobalEvents(
+      const flutter::EncodableMap& args);
 
   static int64_t WindowManagerPlus::createWindow(
       const std::vector<std::string>& args);
+  // Moves and resizes several windows at once with a single
+  // BeginDeferWindowPos / EndDeferWindowPos batch.
+  static bool WindowManagerPlus::ApplyLayout(const flutter::EncodableMap& args);
+  static void WindowManagerPlus::SetWindowPoolSize(
+      const flutter::EncodableMap& args);
+  static flutter::EncodableMap WindowManagerPlus::GetWindowPoolMetrics();
+  // Returns every display with its bounds, work area and scale factor, and
+  // whether it holds the cursor.
+  static flutter::EncodableList WindowManagerPlus::GetDisplays();
+  // Parks the pooled window's |result| until createWindow hands the window
+  // out, or fails it if |token| is no longer in the pool.
+  static void WindowManagerPlus::WaitForPooledWindow(
+      int64_t token,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  static void WindowManagerPlus::RecordFirstFrame(int64_t window_id);
+  // Removes |window_id| from registry_ and queues its window to be released
+  // once the current message has been handled.
+  static void WindowManagerPlus::QueueWindowRelease(int64_t window_id);
+  static void WindowManagerPlus::QueueWindowRelease(
+      std::shared_ptr<FlutterWindow> window);
+  static void WindowManagerPlus::ReleaseWindows();
+  static flutter::EncodableMap WindowManagerPlus::GetWindowReleaseMetrics();
+  // Creates the next missing pooled window from the message loop, so the
+  // pool never delays the createWindow call that drained it.
+  static void WindowManagerPlus::ScheduleWindowPoolRefill();
+  // Returns the global_event_mask_ bit of |event_name|, or 0 if unknown.
+  static uint32_t WindowManagerPlus::GetWindowEventMask(
+      std::string_view event_name);
 
  private:
   static constexpr auto kFlutterViewWindowClassName = L"FLUTTERVIEW";
   bool g_is_window_fullscreen = false;
-  std::string g_title_bar_style_before_fullscreen;
+  TitleBarStyle g_title_bar_style_before_fullscreen;
   RECT g_frame_before_fullscreen;
   bool g_maximized_before_fullscreen;
   LONG g_style_before_fullscreen;
-  ITaskbarList3* taskbar_ = nullptr;
   double GetDpiForHwnd(HWND hWnd);
+  void WindowManagerPlus::UpdateFrameMode();
   BOOL WindowManagerPlus::RegisterAccessBar(HWND hwnd, BOOL fRegister);
   void PASCAL WindowManagerPlus::AppBarQuerySetPos(HWND hwnd,
                                                    UINT uEdge,
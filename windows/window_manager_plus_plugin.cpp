@@ -11,30 +11,45 @@
 #include <codecvt>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <sstream>
-#include <thread>
 
+#include "dynamic_api.h"
+#include "icon_cache.h"
+#include "method_dispatch.h"
+#include "monitor_cache.h"
+#include "taskbar_list.h"
+#include "topic_bus.h"
 #include "window_manager_plus.h"
+#include "window_method_names.h"
 
 namespace window_manager_plus {
 
+// The OS build number, read once by RegisterWithRegistrar. RtlGetVersion
+// reports the real build whatever the application manifest declares.
+DWORD g_os_build_number = 0;
+
+DWORD DetectOsBuildNumber() {
+  RtlGetVersionFunc rtlGetVersion = DynamicApi::Get().rtl_get_version;
+  if (rtlGetVersion == nullptr)
+    return 0;
+
+  RTL_OSVERSIONINFOW info = {};
+  info.dwOSVersionInfoSize = sizeof(info);
+  if (rtlGetVersion(&info) != 0)
+    return 0;
+  return info.dwBuildNumber;
+}
+
 bool IsWindows11OrGreater() {
-  DWORD dwVersion = 0;
-  DWORD dwBuild = 0;
-
-#pragma warning(push)
-#pragma warning(disable : 4996)
-  dwVersion = GetVersion();
-  // Get the build number.
-  if (dwVersion < 0x80000000)
-    dwBuild = (DWORD)(HIWORD(dwVersion));
-#pragma warning(pop)
-
-  return dwBuild < 22000;
+  return g_os_build_number < 22000;
 }
 
-std::mutex threadMtx;
+static_assert(kSizingEdgeLeft == WMSZ_LEFT &&
+                  kSizingEdgeBottomRight == WMSZ_BOTTOMRIGHT,
+              "SizingEdge must be numbered like WMSZ_*");
+
+// Identifies the timer that flushes coalesced "move" / "resize" events.
+constexpr UINT_PTR kEventCoalescingTimerId = 0x574D50;
 
 class WindowManagerPlusPlugin : public flutter::Plugin {
  public:
@@ -45,6 +60,17 @@ class WindowManagerPlusPlugin : public flutter::Plugin {
   virtual ~WindowManagerPlusPlugin();
 
  private:
+  // State handed to a method handler found in a MethodDispatchTable.
+  struct MethodCallContext {
+    WindowManagerPlusPlugin* plugin;
+    std::shared_ptr<WindowManagerPlus> manager;
+    int64_t window_id;
+    const flutter::EncodableMap& args;
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result;
+  };
+
+  using MethodHandler = void (*)(MethodCallContext& ctx);
+
   std::shared_ptr<WindowManagerPlus> window_manager;
   flutter::PluginRegistrarWindows* registrar;
 
@@ -53,6 +79,13 @@ class WindowManagerPlusPlugin : public flutter::Plugin {
 
   void WindowManagerPlusPlugin::_EmitEvent(std::string eventName);
   void WindowManagerPlusPlugin::_EmitGlobalEvent(std::string eventName);
+  // Records a "move" or "resize" event to be emitted by the next
+  // _FlushCoalescedEvents, merging it with any event still pending.
+  void WindowManagerPlusPlugin::_QueueCoalescedEvent(HWND hWnd, bool isResize);
+  void WindowManagerPlusPlugin::_FlushCoalescedEvents(HWND hWnd);
+  // Emits "move" or "resize" through the event fast path when it is enabled,
+  // otherwise like _EmitEvent.
+  void WindowManagerPlusPlugin::_EmitMoveOrResizeEvent(bool isResize);
   // Called for top-level WindowProc delegation.
   std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
       HWND hWnd,
@@ -68,39 +101,38 @@ class WindowManagerPlusPlugin : public flutter::Plugin {
       const flutter::MethodCall<flutter::EncodableValue>& method_call,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
-  void adjustNCCALCSIZE(HWND hwnd, NCCALCSIZE_PARAMS* sz) {
-    LONG l = 8;
-    LONG t = 8;
+  // Returns the arguments map of |method_call| without copying it, or an
+  // empty map if the call has no arguments.
+  static const flutter::EncodableMap& GetArguments(
+      const flutter::MethodCall<flutter::EncodableValue>& method_call);
 
-    // HMONITOR monitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-    // Don't use `MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST)` above.
+  void adjustNCCALCSIZE(HWND hwnd, NCCALCSIZE_PARAMS* sz) {
+    // Don't look the monitor up from the window (MonitorFromWindow).
     // Because if the window is restored from minimized state, the window is not
     // in the correct monitor. The monitor is always the left-most monitor.
     // https://github.com/leanflutter/window_manager/issues/489
-    HMONITOR monitor = MonitorFromRect(&sz->rgrc[0], MONITOR_DEFAULTTONEAREST);
-    if (monitor != NULL) {
-      MONITORINFO monitorInfo;
-      monitorInfo.cbSize = sizeof(MONITORINFO);
-      if (TRUE == GetMonitorInfo(monitor, &monitorInfo)) {
-        l = sz->rgrc[0].left - monitorInfo.rcWork.left;
-        t = sz->rgrc[0].top - monitorInfo.rcWork.top;
-      } else {
-        // GetMonitorInfo failed, use (8, 8) as default value
-      }
-    } else {
-      // unreachable code
-    }
+    RECT workArea =
+        MonitorCache::GetInstance().FromRect(sz->rgrc[0]).work_area;
+    ProcRect rect = ToProcRect(sz->rgrc[0]);
+    InsetToWorkArea(ToProcRect(workArea), &rect);
+    sz->rgrc[0] = ToRect(rect);
+  }
+
+  static ProcRect ToProcRect(const RECT& rect) {
+    return {rect.left, rect.top, rect.right, rect.bottom};
+  }
 
-    sz->rgrc[0].left -= l;
-    sz->rgrc[0].top -= t;
-    sz->rgrc[0].right += l;
-    sz->rgrc[0].bottom += t;
+  static RECT ToRect(const ProcRect& rect) {
+    return {rect.left, rect.top, rect.right, rect.bottom};
   }
 };
 
 // static
 void WindowManagerPlusPlugin::RegisterWithRegistrar(
     flutter::PluginRegistrarWindows* registrar) {
+  if (g_os_build_number == 0)
+    g_os_build_number = DetectOsBuildNumber();
+
   auto plugin = std::make_unique<WindowManagerPlusPlugin>(registrar);
 
   registrar->AddPlugin(std::move(plugin));
@@ -139,26 +171,21 @@ WindowManagerPlusPlugin::~WindowManagerPlusPlugin() {
 #endif
   registrar->UnregisterTopLevelWindowProcDelegate(window_proc_id);
   window_manager->channel = nullptr;
+  window_manager->SetEventFastPath(
+      {{flutter::EncodableValue("enabled"), flutter::EncodableValue(false)}});
 
   auto id = window_manager->id;
-  if (WindowManagerPlus::windowManagers_.find(id) !=
-      WindowManagerPlus::windowManagers_.end()) {
-    WindowManagerPlus::windowManagers_.erase(id);
+  TopicBus::GetInstance().UnsubscribeAll(id);
+  // The app is exiting with its main window.
+  if (id == WindowManagerPlus::registry_.kMainWindowId) {
+    IconCache::GetInstance().Shutdown();
   }
-  if (WindowManagerPlus::windows_.find(id) !=
-      WindowManagerPlus::windows_.end()) {
-    WindowManagerPlus::windows_[id]->Destroy();
-    // calling WindowManager::windows_.erase(id); will cause a crash
-    std::thread([&]() {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-      threadMtx.lock();
-      if (WindowManagerPlus::windows_.find(id) !=
-          WindowManagerPlus::windows_.end()) {
-        WindowManagerPlus::windows_.erase(id);
-      }
-      threadMtx.unlock();
-    }).detach();
+  if (auto window = WindowManagerPlus::registry_.FindWindow(id)) {
+    window->Destroy();
   }
+  // Releasing the window while its engine is still shutting down crashes,
+  // so it is released once the current message has been handled.
+  WindowManagerPlus::QueueWindowRelease(id);
 }
 
 void WindowManagerPlusPlugin::_EmitEvent(std::string eventName) {
@@ -174,9 +201,14 @@ void WindowManagerPlusPlugin::_EmitEvent(std::string eventName) {
 }
 
 void WindowManagerPlusPlugin::_EmitGlobalEvent(std::string eventName) {
-  for (auto wManagerPair : WindowManagerPlus::windowManagers_) {
-    if (wManagerPair.second->channel) {
-      wManagerPair.second->channel->InvokeMethod(
+  uint32_t eventMask = WindowManagerPlus::GetWindowEventMask(eventName);
+  WindowManagerPlus::registry_.ForEachManager([&](int64_t,
+                                                  const auto& wManager) {
+    if (eventMask != 0 && (wManager->global_event_mask_ & eventMask) == 0) {
+      return;
+    }
+    if (wManager->channel) {
+      wManager->channel->InvokeMethod(
           "onEvent",
           std::make_unique<flutter::EncodableValue>(flutter::EncodableMap{
               {flutter::EncodableValue("eventName"),
@@ -184,7 +216,54 @@ void WindowManagerPlusPlugin::_EmitGlobalEvent(std::string eventName) {
               {flutter::EncodableValue("windowId"),
                flutter::EncodableValue(window_manager->id)}}));
     }
+  });
+}
+
+void WindowManagerPlusPlugin::_QueueCoalescedEvent(HWND hWnd, bool isResize) {
+  bool& pending = isResize ? window_manager->is_resize_event_pending_
+                           : window_manager->is_move_event_pending_;
+  if (window_manager->event_coalescing_interval_ == 0) {
+    _EmitMoveOrResizeEvent(isResize);
+    return;
   }
+
+  if (pending) {
+    window_manager->coalesced_event_count_++;
+    return;
+  }
+  pending = true;
+
+  if (!window_manager->is_event_coalescing_timer_set_) {
+    // Emit the first event of a burst right away so listeners don't lag
+    // behind the drag, then let the timer deliver the rest.
+    _FlushCoalescedEvents(hWnd);
+    SetTimer(hWnd, kEventCoalescingTimerId,
+             window_manager->event_coalescing_interval_, nullptr);
+    window_manager->is_event_coalescing_timer_set_ = true;
+  }
+}
+
+void WindowManagerPlusPlugin::_FlushCoalescedEvents(HWND hWnd) {
+  if (window_manager->is_move_event_pending_) {
+    window_manager->is_move_event_pending_ = false;
+    _EmitMoveOrResizeEvent(false);
+  }
+  if (window_manager->is_resize_event_pending_) {
+    window_manager->is_resize_event_pending_ = false;
+    _EmitMoveOrResizeEvent(true);
+  }
+}
+
+void WindowManagerPlusPlugin::_EmitMoveOrResizeEvent(bool isResize) {
+  const char* eventName = isResize ? "resize" : "move";
+  int32_t eventId = isResize ? WINDOW_MANAGER_PLUS_EVENT_RESIZE
+                             : WINDOW_MANAGER_PLUS_EVENT_MOVE;
+  if (window_manager->PushFastPathEvent(eventId)) {
+    // Only this window's own listeners read the ring.
+    _EmitGlobalEvent(eventName);
+    return;
+  }
+  _EmitEvent(eventName);
 }
 
 std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
@@ -194,50 +273,55 @@ std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
     LPARAM lParam) {
   std::optional<LRESULT> result = std::nullopt;
 
+  if (message == WM_DISPLAYCHANGE || message == WM_SETTINGCHANGE ||
+      message == WM_DPICHANGED) {
+    MonitorCache::GetInstance().Invalidate();
+  }
+
+  if (message == IconCache::GetDecodedMessage()) {
+    window_manager->ApplyPendingIcon();
+    return 0;
+  }
+
+  // Sent again when Explorer restarts and recreates the taskbar buttons.
+  static const UINT taskbar_button_created_message =
+      RegisterWindowMessage(L"TaskbarButtonCreated");
+  if (message == taskbar_button_created_message) {
+    TaskbarList::GetInstance().Retry();
+    window_manager->ResetProgressBar();
+  }
+
   if (message == WM_DPICHANGED) {
     window_manager->pixel_ratio_ =
         (float)LOWORD(wParam) / USER_DEFAULT_SCREEN_DPI;
+    window_manager->UpdateTrackSizeLimits();
     window_manager->ForceChildRefresh();
   }
 
-  if (wParam && message == WM_NCCALCSIZE) {
-    if (window_manager->IsFullScreen() &&
-        window_manager->title_bar_style_ != "normal") {
-      if (window_manager->is_frameless_) {
-        adjustNCCALCSIZE(hWnd, reinterpret_cast<NCCALCSIZE_PARAMS*>(lParam));
-      }
-      return 0;
-    }
-    // This must always be before handling title_bar_style_ == "hidden" so
-    // the `if TitleBarStyle.hidden` doesn't get executed.
-    if (window_manager->is_frameless_) {
-      if (window_manager->IsMaximized()) {
-        adjustNCCALCSIZE(hWnd, reinterpret_cast<NCCALCSIZE_PARAMS*>(lParam));
-      }
-      return 0;
-    }
+  const uint8_t frame_mode = window_manager->frame_mode_;
 
-    // This must always be last.
-    if (wParam && window_manager->title_bar_style_ == "hidden") {
-      if (window_manager->IsMaximized()) {
-        // Adjust the borders when maximized so the app isn't cut off
-        adjustNCCALCSIZE(hWnd, reinterpret_cast<NCCALCSIZE_PARAMS*>(lParam));
-      } else {
-        NCCALCSIZE_PARAMS* sz = reinterpret_cast<NCCALCSIZE_PARAMS*>(lParam);
-        // on windows 10, if set to 0, there's a white line at the top
-        // of the app and I've yet to find a way to remove that.
-        sz->rgrc[0].top += IsWindows11OrGreater() ? 0 : 1;
-        // The following lines are required for resizing the window.
-        // https://github.com/leanflutter/window_manager/issues/483
-        sz->rgrc[0].right -= 8;
-        sz->rgrc[0].bottom -= 8;
-        sz->rgrc[0].left -= -8;
+  if (wParam && message == WM_NCCALCSIZE) {
+    // Only a frameless window or a hidden title bar looks at the placement.
+    bool is_maximized = frame_mode != 0 && window_manager->IsMaximized();
+    NCCALCSIZE_PARAMS* sz = reinterpret_cast<NCCALCSIZE_PARAMS*>(lParam);
+    switch (NcCalcSizeAction(frame_mode, window_manager->IsFullScreen(),
+                             is_maximized)) {
+      case FrameAction::kInsetToWorkArea:
+        adjustNCCALCSIZE(hWnd, sz);
+        return 0;
+      case FrameAction::kHideTitleBar: {
+        ProcRect rect = ToProcRect(sz->rgrc[0]);
+        InsetForHiddenTitleBar(IsWindows11OrGreater(), &rect);
+        sz->rgrc[0] = ToRect(rect);
+        // Previously (WVR_HREDRAW | WVR_VREDRAW), but returning 0 or 1
+        // doesn't actually break anything so I've set it to 0. Unless
+        // someone pointed a problem in the future.
+        return 0;
       }
-
-      // Previously (WVR_HREDRAW | WVR_VREDRAW), but returning 0 or 1 doesn't
-      // actually break anything so I've set it to 0. Unless someone pointed a
-      // problem in the future.
-      return 0;
+      case FrameAction::kReturnZero:
+        return 0;
+      default:
+        break;
     }
   } else if (message == WM_NCHITTEST) {
     if (!window_manager->is_resizable_) {
@@ -245,19 +329,13 @@ std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
     }
   } else if (message == WM_GETMINMAXINFO) {
     MINMAXINFO* info = reinterpret_cast<MINMAXINFO*>(lParam);
-    // For the special "unconstrained" values, leave the defaults.
-    if (window_manager->minimum_size_.x != 0)
-      info->ptMinTrackSize.x = static_cast<LONG>(
-          window_manager->minimum_size_.x * window_manager->pixel_ratio_);
-    if (window_manager->minimum_size_.y != 0)
-      info->ptMinTrackSize.y = static_cast<LONG>(
-          window_manager->minimum_size_.y * window_manager->pixel_ratio_);
-    if (window_manager->maximum_size_.x != -1)
-      info->ptMaxTrackSize.x = static_cast<LONG>(
-          window_manager->maximum_size_.x * window_manager->pixel_ratio_);
-    if (window_manager->maximum_size_.y != -1)
-      info->ptMaxTrackSize.y = static_cast<LONG>(
-          window_manager->maximum_size_.y * window_manager->pixel_ratio_);
+    ProcPoint minTrackSize = {info->ptMinTrackSize.x, info->ptMinTrackSize.y};
+    ProcPoint maxTrackSize = {info->ptMaxTrackSize.x, info->ptMaxTrackSize.y};
+    ApplyTrackSizeLimits(window_manager->min_track_size_limit_,
+                         window_manager->max_track_size_limit_, &minTrackSize,
+                         &maxTrackSize);
+    info->ptMinTrackSize = {minTrackSize.x, minTrackSize.y};
+    info->ptMaxTrackSize = {maxTrackSize.x, maxTrackSize.y};
     result = 0;
   } else if (message == WM_NCACTIVATE) {
     if (wParam != 0) {
@@ -266,10 +344,40 @@ std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
       _EmitEvent("blur");
     }
 
-    if (window_manager->title_bar_style_ == "hidden" ||
-        window_manager->is_frameless_)
+    if (NcActivateAction(frame_mode) == FrameAction::kReturnOne)
       return 1;
+  } else if (message == WM_TIMER && wParam == kEventCoalescingTimerId) {
+    if (!window_manager->is_move_event_pending_ &&
+        !window_manager->is_resize_event_pending_) {
+      // Nothing arrived during the last interval, the burst is over.
+      KillTimer(hWnd, kEventCoalescingTimerId);
+      window_manager->is_event_coalescing_timer_set_ = false;
+    }
+    _FlushCoalescedEvents(hWnd);
+    return 0;
+  } else if (message == WM_TIMER && wParam == kProgressBarTimerId) {
+    window_manager->ApplyProgressBar();
+    return 0;
+  } else if (message == WM_TIMER && wParam == kBoundsAnimationTimerId) {
+    if (!window_manager->StepBoundsAnimation()) {
+      // Listeners only hear about the animation once, when it is over.
+      const RECT& from = window_manager->bounds_animation_from_;
+      const RECT& to = window_manager->bounds_animation_to_;
+      if (from.right - from.left != to.right - to.left ||
+          from.bottom - from.top != to.bottom - to.top) {
+        _EmitEvent("resized");
+      }
+      if (from.left != to.left || from.top != to.top) {
+        _EmitEvent("moved");
+      }
+    }
+    return 0;
   } else if (message == WM_EXITSIZEMOVE) {
+    _FlushCoalescedEvents(hWnd);
+    if (window_manager->is_event_coalescing_timer_set_) {
+      KillTimer(hWnd, kEventCoalescingTimerId);
+      window_manager->is_event_coalescing_timer_set_ = false;
+    }
     if (window_manager->is_resizing_) {
       _EmitEvent("resized");
       window_manager->is_resizing_ = false;
@@ -281,95 +389,34 @@ std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
     return false;
   } else if (message == WM_MOVING) {
     window_manager->is_moving_ = true;
-    _EmitEvent("move");
+    _QueueCoalescedEvent(hWnd, false);
     return false;
   } else if (message == WM_SIZING) {
     window_manager->is_resizing_ = true;
-    _EmitEvent("resize");
+    _QueueCoalescedEvent(hWnd, true);
 
     if (window_manager->aspect_ratio_ > 0) {
       RECT* rect = (LPRECT)lParam;
-
-      double aspect_ratio = window_manager->aspect_ratio_;
-
-      int new_width = static_cast<int>(rect->right - rect->left);
-      int new_height = static_cast<int>(rect->bottom - rect->top);
-
-      bool is_resizing_horizontally =
-          wParam == WMSZ_LEFT || wParam == WMSZ_RIGHT ||
-          wParam == WMSZ_TOPLEFT || wParam == WMSZ_BOTTOMLEFT;
-
-      if (is_resizing_horizontally) {
-        new_height = static_cast<int>(new_width / aspect_ratio);
-      } else {
-        new_width = static_cast<int>(new_height * aspect_ratio);
-      }
-
-      int left = rect->left;
-      int top = rect->top;
-      int right = rect->right;
-      int bottom = rect->bottom;
-
-      switch (wParam) {
-        case WMSZ_RIGHT:
-        case WMSZ_BOTTOM:
-          right = new_width + left;
-          bottom = top + new_height;
-          break;
-        case WMSZ_TOP:
-          right = new_width + left;
-          top = bottom - new_height;
-          break;
-        case WMSZ_LEFT:
-        case WMSZ_TOPLEFT:
-          left = right - new_width;
-          top = bottom - new_height;
-          break;
-        case WMSZ_TOPRIGHT:
-          right = left + new_width;
-          top = bottom - new_height;
-          break;
-        case WMSZ_BOTTOMLEFT:
-          left = right - new_width;
-          bottom = top + new_height;
-          break;
-        case WMSZ_BOTTOMRIGHT:
-          right = left + new_width;
-          bottom = top + new_height;
-          break;
-      }
-
-      rect->left = left;
-      rect->top = top;
-      rect->right = right;
-      rect->bottom = bottom;
+      ProcRect sizingRect = ToProcRect(*rect);
+      ApplyAspectRatio(window_manager->aspect_ratio_, static_cast<int>(wParam),
+                       &sizingRect);
+      *rect = ToRect(sizingRect);
     }
   } else if (message == WM_SIZE) {
-    if (window_manager->IsFullScreen() && wParam == SIZE_MAXIMIZED &&
-        window_manager->last_state != STATE_FULLSCREEN_ENTERED) {
-      _EmitEvent("enter-full-screen");
-      window_manager->last_state = STATE_FULLSCREEN_ENTERED;
-    } else if (!window_manager->IsFullScreen() && wParam == SIZE_RESTORED &&
-               window_manager->last_state == STATE_FULLSCREEN_ENTERED) {
-      window_manager->ForceChildRefresh();
-      _EmitEvent("leave-full-screen");
-      window_manager->last_state = STATE_NORMAL;
-    } else if (window_manager->last_state != STATE_FULLSCREEN_ENTERED) {
-      if (wParam == SIZE_MAXIMIZED) {
-        _EmitEvent("maximize");
-        window_manager->last_state = STATE_MAXIMIZED;
-      } else if (wParam == SIZE_MINIMIZED) {
-        _EmitEvent("minimize");
-        window_manager->last_state = STATE_MINIMIZED;
+    SizeKind kind = wParam == SIZE_MAXIMIZED   ? SizeKind::kMaximized
+                    : wParam == SIZE_MINIMIZED ? SizeKind::kMinimized
+                    : wParam == SIZE_RESTORED  ? SizeKind::kRestored
+                                               : SizeKind::kOther;
+    SizeTransition transition = NextSizeState(
+        window_manager->last_state, window_manager->IsFullScreen(), kind);
+    if (transition.event != nullptr) {
+      if (transition.refresh_children) {
+        window_manager->ForceChildRefresh();
+      }
+      _EmitEvent(transition.event);
+      window_manager->last_state = transition.state;
+      if (kind == SizeKind::kMinimized) {
         return 0;
-      } else if (wParam == SIZE_RESTORED) {
-        if (window_manager->last_state == STATE_MAXIMIZED) {
-          _EmitEvent("unmaximize");
-          window_manager->last_state = STATE_NORMAL;
-        } else if (window_manager->last_state == STATE_MINIMIZED) {
-          _EmitEvent("restore");
-          window_manager->last_state = STATE_NORMAL;
-        }
       }
     }
   } else if (message == WM_CLOSE) {
@@ -395,309 +442,610 @@ std::optional<LRESULT> WindowManagerPlusPlugin::HandleWindowProc(
   return result;
 }
 
+const flutter::EncodableMap& WindowManagerPlusPlugin::GetArguments(
+    const flutter::MethodCall<flutter::EncodableValue>& method_call) {
+  static const flutter::EncodableMap empty_args;
+  const auto* args =
+      std::get_if<flutter::EncodableMap>(method_call.arguments());
+  return args != nullptr ? *args : empty_args;
+}
+
 void WindowManagerPlusPlugin::HandleStaticMethodCall(
     const flutter::MethodCall<flutter::EncodableValue>& method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  std::string method_name = method_call.method_name();
-
-  const flutter::EncodableMap& args =
-      method_call.arguments()->IsNull()
-          ? flutter::EncodableMap()
-          : std::get<flutter::EncodableMap>(*method_call.arguments());
-  /*auto windowId =
-      args.find(flutter::EncodableValue("windowId")) != args.end()
-          ? std::get<int>(args.at(flutter::EncodableValue("windowId")))
-          : -1;*/
-
-  if (method_name.compare("createWindow") == 0) {
-    auto encodedArgs = args.at(flutter::EncodableValue("args")).IsNull()
-                           ? flutter::EncodableList()
-                           : std::get<flutter::EncodableList>(
-                                 args.at(flutter::EncodableValue("args")));
-    std::vector<std::string> windowArgs;
-    for (const auto& arg : encodedArgs) {
-      if (std::holds_alternative<std::string>(arg)) {
-        windowArgs.push_back(std::get<std::string>(arg));
-      }
-    }
-    auto newWindowId = WindowManagerPlus::createWindow(windowArgs);
-    result->Success(newWindowId >= 0 ? flutter ::EncodableValue(newWindowId)
-                                     : flutter ::EncodableValue());
-  } else if (method_name.compare("getAllWindowManagerIds") == 0) {
-    std::vector<int64_t> windowIds;
-    for (auto& window : WindowManagerPlus::windowManagers_) {
-      windowIds.push_back(window.first);
-    }
-    result->Success(flutter::EncodableValue(windowIds));
-  } else {
+  static constexpr auto kStaticMethods =
+      MakeMethodDispatchTable<MethodHandler>({
+          {"applyLayout",
+           [](MethodCallContext& ctx) {
+             bool value = WindowManagerPlus::ApplyLayout(ctx.args);
+             ctx.result->Success(flutter::EncodableValue(value));
+           }},
+          {"createWindow",
+           [](MethodCallContext& ctx) {
+             const auto& encoded_args =
+                 ctx.args.at(flutter::EncodableValue("args"));
+             std::vector<std::string> windowArgs;
+             if (const auto* list =
+                     std::get_if<flutter::EncodableList>(&encoded_args)) {
+               for (const auto& arg : *list) {
+                 if (std::holds_alternative<std::string>(arg)) {
+                   windowArgs.push_back(std::get<std::string>(arg));
+                 }
+               }
+             }
+             auto newWindowId = WindowManagerPlus::createWindow(windowArgs);
+             ctx.result->Success(newWindowId >= 0
+                                     ? flutter::EncodableValue(newWindowId)
+                                     : flutter::EncodableValue());
+           }},
+          {"getAllWindowManagerIds",
+           [](MethodCallContext& ctx) {
+             std::vector<int64_t> windowIds;
+             WindowManagerPlus::registry_.ForEachManager(
+                 [&](int64_t id, const auto&) { windowIds.push_back(id); });
+             ctx.result->Success(flutter::EncodableValue(windowIds));
+           }},
+          {"getDisplays",
+           [](MethodCallContext& ctx) {
+             flutter::EncodableList value = WindowManagerPlus::GetDisplays();
+             ctx.result->Success(flutter::EncodableValue(value));
+           }},
+          {"getTaskbarMetrics",
+           [](MethodCallContext& ctx) {
+             const TaskbarList& taskbar = TaskbarList::GetInstance();
+             flutter::EncodableMap value = {
+                 {flutter::EncodableValue("creationTime"),
+                  flutter::EncodableValue(taskbar.GetCreationMilliseconds())},
+                 {flutter::EncodableValue("creationCount"),
+                  flutter::EncodableValue(taskbar.GetCreationCount())},
+             };
+             ctx.result->Success(flutter::EncodableValue(value));
+           }},
+          {"getTopicMetrics",
+           [](MethodCallContext& ctx) {
+             flutter::EncodableMap value = TopicBus::GetInstance().GetMetrics();
+             ctx.result->Success(flutter::EncodableValue(value));
+           }},
+          {"getWindowPoolMetrics",
+           [](MethodCallContext& ctx) {
+             flutter::EncodableMap value =
+                 WindowManagerPlus::GetWindowPoolMetrics();
+             ctx.result->Success(flutter::EncodableValue(value));
+           }},
+          {"getWindowReleaseMetrics",
+           [](MethodCallContext& ctx) {
+             flutter::EncodableMap value =
+                 WindowManagerPlus::GetWindowReleaseMetrics();
+             ctx.result->Success(flutter::EncodableValue(value));
+           }},
+          {"setTopicOptions",
+           [](MethodCallContext& ctx) {
+             const auto& topic = std::get<std::string>(
+                 ctx.args.at(flutter::EncodableValue("topic")));
+             int interval = std::get<int>(
+                 ctx.args.at(flutter::EncodableValue("coalesceInterval")));
+             TopicBus::GetInstance().SetCoalesceInterval(
+                 topic, interval > 0 ? static_cast<UINT>(interval) : 0);
+             ctx.result->Success(flutter::EncodableValue(true));
+           }},
+          {"setWindowPoolSize",
+           [](MethodCallContext& ctx) {
+             WindowManagerPlus::SetWindowPoolSize(ctx.args);
+             ctx.result->Success(flutter::EncodableValue(true));
+           }},
+      });
+  static_assert(kStaticMethods.IsSorted(),
+                "kStaticMethods must be sorted by method name");
+
+  MethodHandler handler = kStaticMethods.Find(method_call.method_name());
+  if (handler == nullptr) {
     result->NotImplemented();
+    return;
   }
+
+  MethodCallContext ctx{nullptr, nullptr, -1, GetArguments(method_call),
+                        std::move(result)};
+  handler(ctx);
 }
 
 void WindowManagerPlusPlugin::HandleMethodCall(
     const flutter::MethodCall<flutter::EncodableValue>& method_call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
-  std::string method_name = method_call.method_name();
-
-  const flutter::EncodableMap& args =
-      method_call.arguments()->IsNull()
-          ? flutter::EncodableMap()
-          : std::get<flutter::EncodableMap>(*method_call.arguments());
-  auto windowId =
-      args.find(flutter::EncodableValue("windowId")) != args.end()
-          ? std::get<int>(args.at(flutter::EncodableValue("windowId")))
-          : -1;
-  auto wManager = window_manager;
-  if (windowId >= 0 && WindowManagerPlus::windowManagers_.find(windowId) !=
-                           WindowManagerPlus::windowManagers_.end()) {
-    wManager = WindowManagerPlus::windowManagers_[windowId];
+  static constexpr auto kMethods = MakeMethodDispatchTable<MethodHandler>({
+      {"blur",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Blur();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"close",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Close();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"destroy",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Destroy();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"dock",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Dock(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"ensureInitialized",
+       [](MethodCallContext& ctx) {
+         auto windowId = ctx.window_id;
+         if (windowId < 0) {
+           ctx.result->Error(
+               "0", "Cannot ensureInitialized! windowId >= 0 is required");
+           return;
+         }
+         if (!WindowManagerPlus::registry_.FindWindow(windowId) &&
+             windowId != WindowManagerPlus::registry_.kMainWindowId) {
+           ctx.result->Error(
+               "0", "Cannot ensureInitialized! windowId was not created");
+           return;
+         }
+         auto plugin = ctx.plugin;
+         auto window_manager = plugin->window_manager;
+
+         // if exist manager，bug channel is invalid，clear old state
+         auto existing_manager =
+             WindowManagerPlus::registry_.FindManager(windowId);
+         if (existing_manager) {
+           if (existing_manager->channel) {
+             existing_manager->channel->SetMethodCallHandler(nullptr);
+             existing_manager->channel.reset();  // clear old channel
+           }
+         }
+
+         window_manager->id = windowId;
+         window_manager->native_window = ::GetAncestor(
+             plugin->registrar->GetView()->GetNativeWindow(), GA_ROOT);
+
+         // create new channel
+         window_manager->channel =
+             std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+                 plugin->registrar->messenger(),
+                 "window_manager_plus_" + std::to_string(windowId),
+                 &flutter::StandardMethodCodec::GetInstance());
+         window_manager->channel->SetMethodCallHandler(
+             [plugin](const auto& call, auto result) {
+               plugin->HandleMethodCall(call, std::move(result));
+             });
+
+         WindowManagerPlus::registry_.SetManager(windowId, window_manager);
+         ctx.result->Success(flutter::EncodableValue(true));
+         plugin->_EmitGlobalEvent("initialized");
+       }},
+      {"firstFrameRasterized",
+       [](MethodCallContext& ctx) {
+         WindowManagerPlus::RecordFirstFrame(ctx.manager->id);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"focus",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Focus();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"getBounds",
+       [](MethodCallContext& ctx) {
+         flutter::EncodableMap value = ctx.manager->GetBounds(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getCoalescedEventCount",
+       [](MethodCallContext& ctx) {
+         int64_t value = ctx.manager->GetCoalescedEventCount();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getElidedProgressBarCallCount",
+       [](MethodCallContext& ctx) {
+         int64_t value = ctx.manager->GetElidedProgressBarCallCount();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getOpacity",
+       [](MethodCallContext& ctx) {
+         double value = ctx.manager->GetOpacity();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getRefreshMetrics",
+       [](MethodCallContext& ctx) {
+         flutter::EncodableMap value = ctx.manager->GetRefreshMetrics();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getTitle",
+       [](MethodCallContext& ctx) {
+         std::string value = ctx.manager->GetTitle();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getTitleBarHeight",
+       [](MethodCallContext& ctx) {
+         int value = ctx.manager->GetTitleBarHeight();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"getWindowState",
+       [](MethodCallContext& ctx) {
+         flutter::EncodableMap value = ctx.manager->GetWindowState(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"hasShadow",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->HasShadow();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"hide",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Hide();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"invokeMethodToWindow",
+       [](MethodCallContext& ctx) {
+         auto targetWindowId =
+             ctx.args.at(flutter::EncodableValue("targetWindowId")).LongValue();
+         auto targetManager =
+             WindowManagerPlus::registry_.FindManager(targetWindowId);
+         if (!targetManager) {
+           ctx.result->Error(
+               "0", "Cannot invokeMethodToWindow! targetWindowId not found");
+           return;
+         }
+         auto result_ =
+             std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>(
+                 std::move(ctx.result));
+         targetManager->channel->InvokeMethod(
+             "onEvent",
+             std::make_unique<flutter::EncodableValue>(
+                 ctx.args.at(flutter::EncodableValue("args"))),
+             std::make_unique<
+                 flutter::MethodResultFunctions<flutter::EncodableValue>>(
+                 [result_](const flutter::EncodableValue* val) {
+                   // Success
+                   result_->Success(*val);
+                 },
+                 [result_](const std::string& error_code,
+                           const std::string& error_message,
+                           const flutter::EncodableValue* error_details) {
+                   // Error
+                   result_->Error(error_code, error_message);
+                 },
+                 [result_]() {
+                   // Not implemented
+                   result_->Error("0", "Method not implemented");
+                 }));
+       }},
+      {"isAlwaysOnBottom",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsAlwaysOnBottom();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isAlwaysOnTop",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsAlwaysOnTop();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isClosable",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsClosable();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isDockable",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsDockable();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isDocked",
+       [](MethodCallContext& ctx) {
+         int value = ctx.manager->IsDocked();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isFocused",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsFocused();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isFullScreen",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsFullScreen();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isMaximizable",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsMaximizable();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isMaximized",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsMaximized();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isMinimizable",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsMinimizable();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isMinimized",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsMinimized();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isPreventClose",
+       [](MethodCallContext& ctx) {
+         auto value = ctx.manager->IsPreventClose();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isResizable",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsResizable();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isSkipTaskbar",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsSkipTaskbar();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"isVisible",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->IsVisible();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"maximize",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Maximize(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"minimize",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Minimize();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"popUpWindowMenu",
+       [](MethodCallContext& ctx) {
+         ctx.manager->PopUpWindowMenu(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"publishTopic",
+       [](MethodCallContext& ctx) {
+         const auto& topic = std::get<std::string>(
+             ctx.args.at(flutter::EncodableValue("topic")));
+         size_t count = TopicBus::GetInstance().Publish(
+             topic, ctx.manager->id,
+             ctx.args.at(flutter::EncodableValue("value")));
+         ctx.result->Success(
+             flutter::EncodableValue(static_cast<int64_t>(count)));
+       }},
+      {"restore",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Restore();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setAlwaysOnBottom",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetAlwaysOnBottom(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setAlwaysOnTop",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetAlwaysOnTop(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setAsFrameless",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetAsFrameless();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setAspectRatio",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetAspectRatio(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setBackgroundColor",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetBackgroundColor(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setBounds",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetBounds(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setBrightness",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetBrightness(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setClosable",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetClosable(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setEventCoalescingInterval",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetEventCoalescingInterval(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setEventFastPath",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetEventFastPath(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setFullScreen",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetFullScreen(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setHasShadow",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetHasShadow(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setIcon",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetIcon(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setIgnoreMouseEvents",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetIgnoreMouseEvents(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setMaximizable",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetMaximizable(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setMaximumSize",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetMaximumSize(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setMinimizable",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetMinimizable(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setMinimumSize",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetMinimumSize(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setOpacity",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetOpacity(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setPreventClose",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetPreventClose(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setProgressBar",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetProgressBar(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setProgressBarUpdateInterval",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetProgressBarUpdateInterval(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setRefreshMode",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetRefreshMode(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setResizable",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetResizable(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setSkipTaskbar",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetSkipTaskbar(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setTitle",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetTitle(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setTitleBarStyle",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetTitleBarStyle(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"setWindowConstraints",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SetWindowConstraints(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"show",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Show();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"startDragging",
+       [](MethodCallContext& ctx) {
+         ctx.manager->StartDragging();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"startResizing",
+       [](MethodCallContext& ctx) {
+         ctx.manager->StartResizing(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"subscribeGlobalEvents",
+       [](MethodCallContext& ctx) {
+         ctx.manager->SubscribeGlobalEvents(ctx.args);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"subscribeTopic",
+       [](MethodCallContext& ctx) {
+         const auto& topic = std::get<std::string>(
+             ctx.args.at(flutter::EncodableValue("topic")));
+         TopicBus::GetInstance().Subscribe(topic, ctx.manager->id);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"undock",
+       [](MethodCallContext& ctx) {
+         bool value = ctx.manager->Undock();
+         ctx.result->Success(flutter::EncodableValue(value));
+       }},
+      {"unmaximize",
+       [](MethodCallContext& ctx) {
+         ctx.manager->Unmaximize();
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"unsubscribeTopic",
+       [](MethodCallContext& ctx) {
+         const auto& topic = std::get<std::string>(
+             ctx.args.at(flutter::EncodableValue("topic")));
+         TopicBus::GetInstance().Unsubscribe(topic, ctx.manager->id);
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+      {"waitForPooledWindow",
+       [](MethodCallContext& ctx) {
+         // Answered by createWindow once this pooled window is handed out.
+         auto token = ctx.args.at(flutter::EncodableValue("token")).LongValue();
+         WindowManagerPlus::WaitForPooledWindow(token, std::move(ctx.result));
+       }},
+      {"waitUntilReadyToShow",
+       [](MethodCallContext& ctx) {
+         // Nothing to prepare, the taskbar list is created on first use.
+         ctx.result->Success(flutter::EncodableValue(true));
+       }},
+  });
+  static_assert(kMethods.IsSorted(), "kMethods must be sorted by method name");
+  static_assert(kMethods.HasNames(kWindowMethodNames),
+                "kWindowMethodNames must list the methods of kMethods");
+
+  MethodHandler handler = kMethods.Find(method_call.method_name());
+  if (handler == nullptr) {
+    result->NotImplemented();
+    return;
   }
 
-  if (method_name.compare("ensureInitialized") == 0) {
-    if (windowId >= 0) {
-      // if exist manager，bug channel is invalid，clear old state
-      auto it = WindowManagerPlus::windowManagers_.find(windowId);
-      if (it != WindowManagerPlus::windowManagers_.end()) {
-        auto existing_manager = it->second;
-        if (existing_manager->channel) {
-          existing_manager->channel->SetMethodCallHandler(nullptr);
-          existing_manager->channel.reset(); // clear old channel
-        }
+  const flutter::EncodableMap& args = GetArguments(method_call);
+  int64_t windowId = -1;
+  auto wManager = window_manager;
+  auto window_id_it = args.find(flutter::EncodableValue("windowId"));
+  if (window_id_it != args.end()) {
+    windowId = window_id_it->second.LongValue();
+    // ensureInitialized passes the id it is about to register. Any other
+    // call addresses an existing window and must not fall back to this one
+    // when the id is stale.
+    if (method_call.method_name() != "ensureInitialized") {
+      wManager = WindowManagerPlus::registry_.FindManager(windowId);
+      if (!wManager) {
+        result->Error("INVALID_WINDOW_ID",
+                      "No window with windowId " + std::to_string(windowId));
+        return;
       }
-
-      window_manager->id = windowId;
-      window_manager->native_window =
-          ::GetAncestor(registrar->GetView()->GetNativeWindow(), GA_ROOT);
-
-      // create new channel
-      window_manager->channel =
-          std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
-              registrar->messenger(),
-              "window_manager_plus_" + std::to_string(windowId),
-              &flutter::StandardMethodCodec::GetInstance());
-      window_manager->channel->SetMethodCallHandler(
-          [this](const auto& call, auto result) {
-            HandleMethodCall(call, std::move(result));
-          });
-
-      WindowManagerPlus::windowManagers_[windowId] = window_manager;
-      result->Success(flutter::EncodableValue(true));
-      _EmitGlobalEvent("initialized");
-    } else {
-      result->Error("0", "Cannot ensureInitialized! windowId >= 0 is required");
     }
-  } else if (method_name.compare("invokeMethodToWindow") == 0) {
-    auto targetWindowId =
-        std::get<int>(args.at(flutter::EncodableValue("targetWindowId")));
-    if (WindowManagerPlus::windowManagers_.find(targetWindowId) !=
-        WindowManagerPlus::windowManagers_.end()) {
-      auto result_ =
-          std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>>(
-              std::move(result));
-      WindowManagerPlus::windowManagers_[targetWindowId]->channel->InvokeMethod(
-          "onEvent",
-          std::make_unique<flutter::EncodableValue>(
-              args.at(flutter::EncodableValue("args"))),
-          std::make_unique<
-              flutter::MethodResultFunctions<flutter::EncodableValue>>(
-              [result_](const flutter::EncodableValue* val) {
-                // Success
-                result_->Success(*val);
-              },
-              [result_](const std::string& error_code,
-                        const std::string& error_message,
-                        const flutter::EncodableValue* error_details) {
-                // Error
-                result_->Error(error_code, error_message);
-              },
-              [result_]() {
-                // Not implemented
-                result_->Error("0", "Method not implemented");
-              }));
-    } else {
-      result->Error("0",
-                    "Cannot invokeMethodToWindow! targetWindowId not found");
-    }
-  } else if (method_name.compare("waitUntilReadyToShow") == 0) {
-    wManager->WaitUntilReadyToShow();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setAsFrameless") == 0) {
-    wManager->SetAsFrameless();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("destroy") == 0) {
-    wManager->Destroy();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("close") == 0) {
-    wManager->Close();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isPreventClose") == 0) {
-    auto value = wManager->IsPreventClose();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setPreventClose") == 0) {
-    wManager->SetPreventClose(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("focus") == 0) {
-    wManager->Focus();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("blur") == 0) {
-    wManager->Blur();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isFocused") == 0) {
-    bool value = wManager->IsFocused();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("show") == 0) {
-    wManager->Show();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("hide") == 0) {
-    wManager->Hide();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isVisible") == 0) {
-    bool value = wManager->IsVisible();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("isMaximized") == 0) {
-    bool value = wManager->IsMaximized();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("maximize") == 0) {
-    wManager->Maximize(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("unmaximize") == 0) {
-    wManager->Unmaximize();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isMinimized") == 0) {
-    bool value = wManager->IsMinimized();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("minimize") == 0) {
-    wManager->Minimize();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("restore") == 0) {
-    wManager->Restore();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isDockable") == 0) {
-    bool value = wManager->IsDockable();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("isDocked") == 0) {
-    int value = wManager->IsDocked();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("dock") == 0) {
-    wManager->Dock(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("undock") == 0) {
-    bool value = wManager->Undock();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("isFullScreen") == 0) {
-    bool value = wManager->IsFullScreen();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setFullScreen") == 0) {
-    wManager->SetFullScreen(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setAspectRatio") == 0) {
-    wManager->SetAspectRatio(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setBackgroundColor") == 0) {
-    wManager->SetBackgroundColor(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("getBounds") == 0) {
-    flutter::EncodableMap value = wManager->GetBounds(args);
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setBounds") == 0) {
-    wManager->SetBounds(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setMinimumSize") == 0) {
-    wManager->SetMinimumSize(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setMaximumSize") == 0) {
-    wManager->SetMaximumSize(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isResizable") == 0) {
-    bool value = wManager->IsResizable();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setResizable") == 0) {
-    wManager->SetResizable(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isMinimizable") == 0) {
-    bool value = wManager->IsMinimizable();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setMinimizable") == 0) {
-    wManager->SetMinimizable(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isMaximizable") == 0) {
-    bool value = wManager->IsMaximizable();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setMaximizable") == 0) {
-    wManager->SetMaximizable(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isClosable") == 0) {
-    bool value = wManager->IsClosable();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setClosable") == 0) {
-    wManager->SetClosable(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isAlwaysOnTop") == 0) {
-    bool value = wManager->IsAlwaysOnTop();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setAlwaysOnTop") == 0) {
-    wManager->SetAlwaysOnTop(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("isAlwaysOnBottom") == 0) {
-    bool value = wManager->IsAlwaysOnBottom();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setAlwaysOnBottom") == 0) {
-    wManager->SetAlwaysOnBottom(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("getTitle") == 0) {
-    std::string value = wManager->GetTitle();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setTitle") == 0) {
-    wManager->SetTitle(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setTitleBarStyle") == 0) {
-    wManager->SetTitleBarStyle(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("getTitleBarHeight") == 0) {
-    int value = wManager->GetTitleBarHeight();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("isSkipTaskbar") == 0) {
-    bool value = wManager->IsSkipTaskbar();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setSkipTaskbar") == 0) {
-    wManager->SetSkipTaskbar(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setProgressBar") == 0) {
-    wManager->SetProgressBar(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setIcon") == 0) {
-    wManager->SetIcon(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("hasShadow") == 0) {
-    bool value = wManager->HasShadow();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setHasShadow") == 0) {
-    wManager->SetHasShadow(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("getOpacity") == 0) {
-    double value = wManager->GetOpacity();
-    result->Success(flutter::EncodableValue(value));
-  } else if (method_name.compare("setOpacity") == 0) {
-    wManager->SetOpacity(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setBrightness") == 0) {
-    wManager->SetBrightness(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("setIgnoreMouseEvents") == 0) {
-    wManager->SetIgnoreMouseEvents(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("popUpWindowMenu") == 0) {
-    wManager->PopUpWindowMenu(args);
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("startDragging") == 0) {
-    wManager->StartDragging();
-    result->Success(flutter::EncodableValue(true));
-  } else if (method_name.compare("startResizing") == 0) {
-    wManager->StartResizing(args);
-    result->Success(flutter::EncodableValue(true));
-  } else {
-    result->NotImplemented();
   }
+
+  MethodCallContext ctx{this, std::move(wManager), windowId, args,
+                        std::move(result)};
+  handler(ctx);
 }
 
 }  // namespace window_manager_plus
@@ -0,0 +1,36 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_METHOD_NAMES_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_METHOD_NAMES_H_
+
+#include <string_view>
+
+namespace window_manager_plus {
+
+// The methods of the window_manager_plus_<id> channels, in the order of
+// kMethods in WindowManagerPlusPlugin::HandleMethodCall. A static_assert
+// there keeps the two in step; the list lives apart from the handlers so the
+// benchmarks can build the same table without Flutter.
+inline constexpr std::string_view kWindowMethodNames[] = {
+    "blur", "close", "destroy", "dock", "ensureInitialized",
+    "firstFrameRasterized", "focus", "getBounds", "getCoalescedEventCount",
+    "getElidedProgressBarCallCount", "getOpacity", "getRefreshMetrics",
+    "getTitle", "getTitleBarHeight", "getWindowState", "hasShadow", "hide",
+    "invokeMethodToWindow", "isAlwaysOnBottom", "isAlwaysOnTop", "isClosable",
+    "isDockable", "isDocked", "isFocused", "isFullScreen", "isMaximizable",
+    "isMaximized", "isMinimizable", "isMinimized", "isPreventClose",
+    "isResizable", "isSkipTaskbar", "isVisible", "maximize", "minimize",
+    "popUpWindowMenu", "publishTopic", "restore", "setAlwaysOnBottom",
+    "setAlwaysOnTop", "setAsFrameless", "setAspectRatio", "setBackgroundColor",
+    "setBounds", "setBrightness", "setClosable", "setEventCoalescingInterval",
+    "setEventFastPath", "setFullScreen", "setHasShadow", "setIcon",
+    "setIgnoreMouseEvents", "setMaximizable", "setMaximumSize",
+    "setMinimizable", "setMinimumSize", "setOpacity", "setPreventClose",
+    "setProgressBar", "setProgressBarUpdateInterval", "setRefreshMode",
+    "setResizable", "setSkipTaskbar", "setTitle", "setTitleBarStyle",
+    "setWindowConstraints", "show", "startDragging", "startResizing",
+    "subscribeGlobalEvents", "subscribeTopic", "undock", "unmaximize",
+    "unsubscribeTopic", "waitForPooledWindow", "waitUntilReadyToShow",
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_METHOD_NAMES_H_
@@ -0,0 +1,242 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_PROC_CORE_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_PROC_CORE_H_
+
+#include <cstdint>
+
+#define STATE_NORMAL 0
+#define STATE_MAXIMIZED 1
+#define STATE_MINIMIZED 2
+#define STATE_FULLSCREEN_ENTERED 3
+#define STATE_DOCKED 4
+
+namespace window_manager_plus {
+
+// The parts of WindowManagerPlusPlugin::HandleWindowProc that are plain
+// arithmetic or state bookkeeping. Nothing here includes a Windows header:
+// HandleWindowProc converts the message parameters to these types and
+// applies the results, so the logic builds and runs on any platform.
+
+struct ProcPoint {
+  int32_t x;
+  int32_t y;
+};
+
+struct ProcRect {
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+};
+
+// The edge being dragged in WM_SIZING, numbered like WMSZ_*.
+enum SizingEdge : int {
+  kSizingEdgeLeft = 1,
+  kSizingEdgeRight = 2,
+  kSizingEdgeTop = 3,
+  kSizingEdgeTopLeft = 4,
+  kSizingEdgeTopRight = 5,
+  kSizingEdgeBottom = 6,
+  kSizingEdgeBottomLeft = 7,
+  kSizingEdgeBottomRight = 8,
+};
+
+// Bits of WindowManagerPlus::frame_mode_, derived from is_frameless_ and
+// title_bar_style_ so HandleWindowProc tests one integer per message.
+constexpr uint8_t kFrameModeFrameless = 1 << 0;
+constexpr uint8_t kFrameModeHiddenTitleBar = 1 << 1;
+
+// What HandleWindowProc does with a WM_NCCALCSIZE or WM_NCACTIVATE.
+enum class FrameAction {
+  // Leave the message to the default handling.
+  kDefault,
+  // Return 0 with the client rect as proposed.
+  kReturnZero,
+  // Pull the client rect in with InsetToWorkArea and return 0.
+  kInsetToWorkArea,
+  // Cover the title bar with InsetForHiddenTitleBar and return 0.
+  kHideTitleBar,
+  // Return 1 without painting the inactive frame.
+  kReturnOne,
+};
+
+// The kind of WM_SIZE, the subset of SIZE_* the state machine looks at.
+enum class SizeKind { kRestored, kMinimized, kMaximized, kOther };
+
+// What a WM_SIZE changes: the next last_state, the event to emit (or
+// nullptr), and whether the Flutter view must be refreshed first.
+struct SizeTransition {
+  int state;
+  const char* event;
+  bool refresh_children;
+};
+
+// Resizes |rect| to |aspect_ratio| while |edge| is dragged, keeping the
+// opposite edges in place.
+inline void ApplyAspectRatio(double aspect_ratio, int edge, ProcRect* rect) {
+  int new_width = static_cast<int>(rect->right - rect->left);
+  int new_height = static_cast<int>(rect->bottom - rect->top);
+
+  bool is_resizing_horizontally =
+      edge == kSizingEdgeLeft || edge == kSizingEdgeRight ||
+      edge == kSizingEdgeTopLeft || edge == kSizingEdgeBottomLeft;
+
+  if (is_resizing_horizontally) {
+    new_height = static_cast<int>(new_width / aspect_ratio);
+  } else {
+    new_width = static_cast<int>(new_height * aspect_ratio);
+  }
+
+  int left = rect->left;
+  int top = rect->top;
+  int right = rect->right;
+  int bottom = rect->bottom;
+
+  switch (edge) {
+    case kSizingEdgeRight:
+    case kSizingEdgeBottom:
+      right = new_width + left;
+      bottom = top + new_height;
+      break;
+    case kSizingEdgeTop:
+      right = new_width + left;
+      top = bottom - new_height;
+      break;
+    case kSizingEdgeLeft:
+    case kSizingEdgeTopLeft:
+      left = right - new_width;
+      top = bottom - new_height;
+      break;
+    case kSizingEdgeTopRight:
+      right = left + new_width;
+      top = bottom - new_height;
+      break;
+    case kSizingEdgeBottomLeft:
+      left = right - new_width;
+      bottom = top + new_height;
+      break;
+    case kSizingEdgeBottomRight:
+      right = left + new_width;
+      bottom = top + new_height;
+      break;
+  }
+
+  rect->left = left;
+  rect->top = top;
+  rect->right = right;
+  rect->bottom = bottom;
+}
+
+// Scales the logical |size| limit by |pixel_ratio|. Components equal to
+// |unconstrained| (0 for a minimum, -1 for a maximum) are kept as they are.
+inline ProcPoint ScaleTrackSizeLimit(const ProcPoint& size,
+                                     int32_t unconstrained,
+                                     double pixel_ratio) {
+  ProcPoint scaled = size;
+  if (size.x != unconstrained)
+    scaled.x = static_cast<int32_t>(size.x * pixel_ratio);
+  if (size.y != unconstrained)
+    scaled.y = static_cast<int32_t>(size.y * pixel_ratio);
+  return scaled;
+}
+
+// Overwrites the track sizes of WM_GETMINMAXINFO with limits already scaled
+// by ScaleTrackSizeLimit. A minimum of 0 or a maximum of -1 means
+// unconstrained and leaves the default.
+inline void ApplyTrackSizeLimits(const ProcPoint& min_limit,
+                                 const ProcPoint& max_limit,
+                                 ProcPoint* min_track_size,
+                                 ProcPoint* max_track_size) {
+  if (min_limit.x != 0)
+    min_track_size->x = min_limit.x;
+  if (min_limit.y != 0)
+    min_track_size->y = min_limit.y;
+  if (max_limit.x != -1)
+    max_track_size->x = max_limit.x;
+  if (max_limit.y != -1)
+    max_track_size->y = max_limit.y;
+}
+
+// Pulls the edges of a maximized or full screen client |rect| in by the
+// amount its top-left corner sticks out of |work_area|, so the invisible
+// resize borders don't cut the app off.
+inline void InsetToWorkArea(const ProcRect& work_area, ProcRect* rect) {
+  int32_t l = rect->left - work_area.left;
+  int32_t t = rect->top - work_area.top;
+
+  rect->left -= l;
+  rect->top -= t;
+  rect->right += l;
+  rect->bottom += t;
+}
+
+// Grows the client |rect| of a window with a hidden title bar over the
+// caption, keeping the 8 pixel resize borders. Before Windows 11 a 0 top
+// leaves a white line at the top of the app, so one pixel is kept there.
+inline void InsetForHiddenTitleBar(bool is_windows_11, ProcRect* rect) {
+  rect->top += is_windows_11 ? 0 : 1;
+  // https://github.com/leanflutter/window_manager/issues/483
+  rect->right -= 8;
+  rect->bottom -= 8;
+  rect->left += 8;
+}
+
+// The frame decision for WM_NCCALCSIZE with a TRUE wParam.
+inline FrameAction NcCalcSizeAction(uint8_t frame_mode,
+                                    bool is_full_screen,
+                                    bool is_maximized) {
+  if (is_full_screen && (frame_mode & kFrameModeHiddenTitleBar)) {
+    return (frame_mode & kFrameModeFrameless) ? FrameAction::kInsetToWorkArea
+                                              : FrameAction::kReturnZero;
+  }
+  // Checked before the hidden title bar, so a frameless window doesn't get
+  // the resize borders of one.
+  if (frame_mode & kFrameModeFrameless) {
+    return is_maximized ? FrameAction::kInsetToWorkArea
+                        : FrameAction::kReturnZero;
+  }
+  if (frame_mode & kFrameModeHiddenTitleBar) {
+    // Maximized, the borders are pulled in so the app isn't cut off.
+    return is_maximized ? FrameAction::kInsetToWorkArea
+                        : FrameAction::kHideTitleBar;
+  }
+  return FrameAction::kDefault;
+}
+
+// The frame decision for WM_NCACTIVATE.
+inline FrameAction NcActivateAction(uint8_t frame_mode) {
+  return (frame_mode & (kFrameModeHiddenTitleBar | kFrameModeFrameless))
+             ? FrameAction::kReturnOne
+             : FrameAction::kDefault;
+}
+
+// The window state machine driven by WM_SIZE.
+inline SizeTransition NextSizeState(int last_state,
+                                    bool is_full_screen,
+                                    SizeKind kind) {
+  if (is_full_screen && kind == SizeKind::kMaximized &&
+      last_state != STATE_FULLSCREEN_ENTERED) {
+    return {STATE_FULLSCREEN_ENTERED, "enter-full-screen", false};
+  }
+  if (!is_full_screen && kind == SizeKind::kRestored &&
+      last_state == STATE_FULLSCREEN_ENTERED) {
+    return {STATE_NORMAL, "leave-full-screen", true};
+  }
+  if (last_state != STATE_FULLSCREEN_ENTERED) {
+    if (kind == SizeKind::kMaximized) {
+      return {STATE_MAXIMIZED, "maximize", false};
+    } else if (kind == SizeKind::kMinimized) {
+      return {STATE_MINIMIZED, "minimize", false};
+    } else if (kind == SizeKind::kRestored) {
+      if (last_state == STATE_MAXIMIZED) {
+        return {STATE_NORMAL, "unmaximize", false};
+      } else if (last_state == STATE_MINIMIZED) {
+        return {STATE_NORMAL, "restore", false};
+      }
+    }
+  }
+  return {last_state, nullptr, false};
+}
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_PROC_CORE_H_
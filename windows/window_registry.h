@@ -0,0 +1,150 @@
+#ifndef WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_REGISTRY_H_
+#define WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace window_manager_plus {
+
+// Tracks the windows created by createWindow and the window managers
+// registered for them, by window id.
+//
+// Entries live in one contiguous vector of slots. A window id is its slot
+// index in the low kSlotBits bits and the slot's generation above them, so a
+// lookup is an index plus a generation compare, and the id of a closed window
+// never resolves to the window that reuses its slot. The first ids handed out
+// are 1, 2, 3, ... as before; slot 0 is reserved for the main window.
+//
+// The registry is only touched from the platform thread, so reads take no
+// lock.
+template <typename Window, typename Manager>
+class WindowRegistry {
+ public:
+  static constexpr int64_t kMainWindowId = 0;
+
+  WindowRegistry() {
+    slots_.emplace_back();
+    slots_[kMainWindowId].in_use = true;
+  }
+
+  // Returns the id of a new, empty entry, or -1 if all slots are used.
+  int64_t Add() {
+    size_t index;
+    if (!free_slots_.empty()) {
+      index = free_slots_.back();
+      free_slots_.pop_back();
+    } else if (slots_.size() < kMaxSlots) {
+      index = slots_.size();
+      slots_.emplace_back();
+    } else {
+      return -1;
+    }
+
+    Slot& slot = slots_[index];
+    slot.in_use = true;
+    return (static_cast<int64_t>(slot.generation) << kSlotBits) | index;
+  }
+
+  std::shared_ptr<Window> FindWindow(int64_t id) const {
+    const Slot* slot = Find(id);
+    return slot != nullptr ? slot->window : nullptr;
+  }
+
+  std::shared_ptr<Manager> FindManager(int64_t id) const {
+    const Slot* slot = Find(id);
+    return slot != nullptr ? slot->manager : nullptr;
+  }
+
+  // Returns false if |id| is not a live entry.
+  bool SetWindow(int64_t id, std::shared_ptr<Window> window) {
+    Slot* slot = Find(id);
+    if (slot == nullptr) {
+      return false;
+    }
+    slot->window = std::move(window);
+    return true;
+  }
+
+  // Returns false if |id| is not a live entry.
+  bool SetManager(int64_t id, std::shared_ptr<Manager> manager) {
+    Slot* slot = Find(id);
+    if (slot == nullptr) {
+      return false;
+    }
+    slot->manager = std::move(manager);
+    return true;
+  }
+
+  // Drops the entry of |id| and returns its window, so the caller decides
+  // when the window is released. The main window's slot is only cleared.
+  std::shared_ptr<Window> Remove(int64_t id) {
+    Slot* slot = Find(id);
+    if (slot == nullptr) {
+      return nullptr;
+    }
+
+    auto window = std::move(slot->window);
+    slot->window = nullptr;
+    slot->manager = nullptr;
+    if (id != kMainWindowId) {
+      slot->in_use = false;
+      slot->generation++;
+      free_slots_.push_back(static_cast<size_t>(id & kSlotMask));
+    }
+    return window;
+  }
+
+  // Calls |callback| with the id and manager of every registered manager, in
+  // slot order.
+  template <typename Callback>
+  void ForEachManager(Callback&& callback) const {
+    for (size_t index = 0; index < slots_.size(); index++) {
+      const Slot& slot = slots_[index];
+      if (slot.manager) {
+        callback((static_cast<int64_t>(slot.generation) << kSlotBits) | index,
+                 slot.manager);
+      }
+    }
+  }
+
+ private:
+  static constexpr int kSlotBits = 16;
+  static constexpr int64_t kSlotMask = (int64_t{1} << kSlotBits) - 1;
+  static constexpr size_t kMaxSlots = size_t{1} << kSlotBits;
+
+  struct Slot {
+    uint32_t generation = 0;
+    bool in_use = false;
+    std::shared_ptr<Window> window;
+    std::shared_ptr<Manager> manager;
+  };
+
+  const Slot* Find(int64_t id) const {
+    if (id < 0) {
+      return nullptr;
+    }
+    size_t index = static_cast<size_t>(id & kSlotMask);
+    if (index >= slots_.size()) {
+      return nullptr;
+    }
+    const Slot& slot = slots_[index];
+    if (!slot.in_use || slot.generation != (id >> kSlotBits)) {
+      return nullptr;
+    }
+    return &slot;
+  }
+
+  Slot* Find(int64_t id) {
+    return const_cast<Slot*>(std::as_const(*this).Find(id));
+  }
+
+  std::vector<Slot> slots_;
+  std::vector<size_t> free_slots_;
+};
+
+}  // namespace window_manager_plus
+
+#endif  // WINDOW_MANAGER_PLUS_PLUGIN_WINDOW_REGISTRY_H_